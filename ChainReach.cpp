@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ChainReach.cpp
+//
+// Author:      David Borland
+//
+// Description: Minimum and maximum reach between any two joints of a bone chain, computed 
+//              in constant time from cumulative bone lengths.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#include "ChainReach.h"
+
+#include "Fixed.h"
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+ChainReachT<T>::ChainReachT() {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+void ChainReachT<T>::Set(const std::vector<T>& lengths) {
+    int numBones = lengths.size();
+
+    // Copy the bone lengths
+    _lengths = lengths;
+
+    // Accumulate the bone lengths, one more joint than bones
+    _cumulative.resize(numBones + 1);
+    _cumulative[0] = Sum(0);
+    for (int i = 0; i < numBones; i++) {
+        _cumulative[i + 1] = _cumulative[i] + Sum(_lengths[i]);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+int ChainReachT<T>::GetNumJoints() const {
+    return _cumulative.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Reach
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// The bone adjacent to joint i on the side of joint j is a fixed distance, and the bones 
+// between it and joint j can fold back over it or extend it, so both radii are that length 
+// plus or minus the sum of the bones in between.
+
+template <class T>
+T ChainReachT<T>::MaxRadius(int i, int j) const {
+    if (j > i) {
+        return _lengths[i] + T(_cumulative[j] - _cumulative[i + 1]);
+    }
+    else if (j < i) {
+        return _lengths[i - 1] + T(_cumulative[i - 1] - _cumulative[j]);
+    }
+    else {
+        return T(0);
+    }
+}
+
+template <class T>
+T ChainReachT<T>::MinRadius(int i, int j) const {
+    if (j > i) {
+        return _lengths[i] - T(_cumulative[j] - _cumulative[i + 1]);
+    }
+    else if (j < i) {
+        return _lengths[i - 1] - T(_cumulative[i - 1] - _cumulative[j]);
+    }
+    else {
+        return T(0);
+    }
+}
+
+
+template class ChainReachT<float>;
+template class ChainReachT<double>;
+template class ChainReachT<Fixed>;
\ No newline at end of file
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ChainReach.h
+//
+// Author:      David Borland
+//
+// Description: Minimum and maximum reach between any two joints of a bone chain, computed 
+//              in constant time from cumulative bone lengths.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#ifndef CHAINREACH_H
+#define CHAINREACH_H
+
+
+#include "ScalarTraits.h"
+
+#include <vector>
+
+
+template <class T>
+class ChainReachT {
+public:
+    // Constructor
+    ChainReachT();                                  // Empty chain
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set values
+    void Set(const std::vector<T>& lengths);        // Set from bone lengths
+
+
+    // Element access
+    int GetNumJoints() const;
+
+
+    // Reach of joint j from joint i.  Equivalent to the old maxRadii[i][j] and minRadii[i][j]
+    T MaxRadius(int i, int j) const;
+    T MinRadius(int i, int j) const;
+
+protected:
+    // Bone lengths
+    std::vector<T> _lengths;
+
+    // Sum of the lengths of all bones before each joint, in a wider type if T has one so the 
+    // difference of two sums is as precise as summing the bones between them
+    typedef typename ScalarTraits<T>::Sum Sum;
+    std::vector<Sum> _cumulative;
+};
+
+
+typedef ChainReachT<double> ChainReach;
+
+
+#endif
\ No newline at end of file
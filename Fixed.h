@@ -0,0 +1,341 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        Fixed.h
+//
+// Author:      David Borland
+//
+// Description: Q32.32 fixed-point number, for instantiating the solver on processors without
+//              floating point hardware.  Uses only 64-bit integer operations, splitting
+//              products and quotients into 32-bit halves, so no wider integer type is needed.
+//              Results that overflow saturate at the largest or smallest value.  Squared
+//              distances must fit, so coordinates should stay within about 20000.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef FIXED_H
+#define FIXED_H
+
+
+#include "Vec2.h"
+#include "Vec3.h"
+
+#include <stdint.h>
+
+#include <iostream>
+
+
+class Fixed {
+public:
+    // Constructors
+    constexpr Fixed();                              // Set to 0
+    explicit constexpr Fixed(int v);                // Set from an integer
+    explicit constexpr Fixed(double v);             // Set from a double, rounding
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set from the raw Q32.32 value
+    static constexpr Fixed FromRaw(int64_t raw);
+
+
+    // Element access
+    constexpr int64_t Raw() const;                  // Raw Q32.32 value
+    explicit constexpr operator double() const;     // Convert to a double
+
+
+    // Operators
+    Fixed operator+(Fixed v) const;
+    Fixed operator-(Fixed v) const;
+    Fixed operator*(Fixed v) const;
+    Fixed operator/(Fixed v) const;
+    constexpr Fixed operator-() const;
+
+    Fixed& operator+=(Fixed v);
+    Fixed& operator-=(Fixed v);
+    Fixed& operator*=(Fixed v);
+    Fixed& operator/=(Fixed v);
+
+    constexpr bool operator==(Fixed v) const;
+    constexpr bool operator!=(Fixed v) const;
+    constexpr bool operator<(Fixed v) const;
+    constexpr bool operator>(Fixed v) const;
+    constexpr bool operator<=(Fixed v) const;
+    constexpr bool operator>=(Fixed v) const;
+
+
+    // Bits after the binary point
+    static const int FractionBits = 32;
+
+protected:
+    // Saturate an unsigned magnitude with the given sign
+    static Fixed Saturate(uint64_t magnitude, bool negative);
+
+    // The internal representation
+    int64_t _raw;
+};
+
+
+// Square root, 0 for negative values, and absolute value.  Found by argument dependent lookup
+// from the templated code.
+Fixed sqrt(Fixed v);
+Fixed fabs(Fixed v);
+
+// Output to a stream
+std::ostream& operator<<(std::ostream& os, Fixed v);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+inline constexpr Fixed::Fixed() : _raw(0) {
+}
+
+inline constexpr Fixed::Fixed(int v) : _raw((int64_t)v * ((int64_t)1 << FractionBits)) {
+}
+
+inline constexpr Fixed::Fixed(double v)
+: _raw(v >= 9.2233720368547748e18 / 4294967296.0 ? INT64_MAX :
+       v <= -9.2233720368547748e18 / 4294967296.0 ? INT64_MIN :
+       (int64_t)(v * 4294967296.0 + (v < 0.0 ? -0.5 : 0.5))) {
+}
+
+inline constexpr Fixed Fixed::FromRaw(int64_t raw) {
+    Fixed f;
+    f._raw = raw;
+
+    return f;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+inline constexpr int64_t Fixed::Raw() const {
+    return _raw;
+}
+
+inline constexpr Fixed::operator double() const {
+    return _raw / 4294967296.0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Operators
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+inline Fixed Fixed::operator+(Fixed v) const {
+    // Overflow when both have the same sign and the sum has the other
+    uint64_t sum = (uint64_t)_raw + (uint64_t)v._raw;
+    int64_t result = (int64_t)sum;
+
+    if ((_raw < 0) == (v._raw < 0) && (result < 0) != (_raw < 0)) {
+        return FromRaw(_raw < 0 ? INT64_MIN : INT64_MAX);
+    }
+
+    return FromRaw(result);
+}
+
+inline Fixed Fixed::operator-(Fixed v) const {
+    // Overflow when the signs differ and the difference has the sign of v
+    uint64_t difference = (uint64_t)_raw - (uint64_t)v._raw;
+    int64_t result = (int64_t)difference;
+
+    if ((_raw < 0) != (v._raw < 0) && (result < 0) != (_raw < 0)) {
+        return FromRaw(_raw < 0 ? INT64_MIN : INT64_MAX);
+    }
+
+    return FromRaw(result);
+}
+
+inline Fixed Fixed::operator*(Fixed v) const {
+    bool negative = (_raw < 0) != (v._raw < 0);
+    uint64_t a = _raw < 0 ? 0 - (uint64_t)_raw : (uint64_t)_raw;
+    uint64_t b = v._raw < 0 ? 0 - (uint64_t)v._raw : (uint64_t)v._raw;
+
+    // (ah 2^32 + al)(bh 2^32 + bl) / 2^32, rounding the low product
+    uint64_t ah = a >> 32;
+    uint64_t al = a & 0xFFFFFFFF;
+    uint64_t bh = b >> 32;
+    uint64_t bl = b & 0xFFFFFFFF;
+
+    uint64_t high = ah * bh;
+    if (high >> 31) return Saturate(UINT64_MAX, negative);
+
+    uint64_t middle1 = ah * bl;
+    uint64_t middle2 = al * bh;
+    uint64_t low = (al * bl + ((uint64_t)1 << 31)) >> 32;
+
+    uint64_t result = high << 32;
+    if (middle1 > UINT64_MAX - result) return Saturate(UINT64_MAX, negative);
+    result += middle1;
+    if (middle2 > UINT64_MAX - result) return Saturate(UINT64_MAX, negative);
+    result += middle2;
+    if (low > UINT64_MAX - result) return Saturate(UINT64_MAX, negative);
+    result += low;
+
+    return Saturate(result, negative);
+}
+
+inline Fixed Fixed::operator/(Fixed v) const {
+    bool negative = (_raw < 0) != (v._raw < 0);
+    uint64_t a = _raw < 0 ? 0 - (uint64_t)_raw : (uint64_t)_raw;
+    uint64_t b = v._raw < 0 ? 0 - (uint64_t)v._raw : (uint64_t)v._raw;
+
+    // Dividing by 0 saturates, like an infinity
+    if (b == 0) return Saturate(a == 0 ? 0 : UINT64_MAX, negative);
+
+    // Integer part, then the fraction one bit at a time from the remainder
+    uint64_t quotient = a / b;
+    uint64_t remainder = a % b;
+    if (quotient >> 31) return Saturate(UINT64_MAX, negative);
+
+    for (int i = 0; i < FractionBits; i++) {
+        // The remainder is less than b, so doubling it can only overflow if b is over 2^63
+        bool carry = remainder >> 63;
+        remainder <<= 1;
+        quotient <<= 1;
+
+        if (carry || remainder >= b) {
+            remainder -= b;
+            quotient |= 1;
+        }
+    }
+
+    return Saturate(quotient, negative);
+}
+
+inline constexpr Fixed Fixed::operator-() const {
+    return FromRaw(_raw == INT64_MIN ? INT64_MAX : -_raw);
+}
+
+
+inline Fixed& Fixed::operator+=(Fixed v) {
+    return *this = *this + v;
+}
+
+inline Fixed& Fixed::operator-=(Fixed v) {
+    return *this = *this - v;
+}
+
+inline Fixed& Fixed::operator*=(Fixed v) {
+    return *this = *this * v;
+}
+
+inline Fixed& Fixed::operator/=(Fixed v) {
+    return *this = *this / v;
+}
+
+
+inline constexpr bool Fixed::operator==(Fixed v) const {
+    return _raw == v._raw;
+}
+
+inline constexpr bool Fixed::operator!=(Fixed v) const {
+    return _raw != v._raw;
+}
+
+inline constexpr bool Fixed::operator<(Fixed v) const {
+    return _raw < v._raw;
+}
+
+inline constexpr bool Fixed::operator>(Fixed v) const {
+    return _raw > v._raw;
+}
+
+inline constexpr bool Fixed::operator<=(Fixed v) const {
+    return _raw <= v._raw;
+}
+
+inline constexpr bool Fixed::operator>=(Fixed v) const {
+    return _raw >= v._raw;
+}
+
+
+inline Fixed Fixed::Saturate(uint64_t magnitude, bool negative) {
+    if (negative) {
+        return FromRaw(magnitude >= (uint64_t)INT64_MAX + 1 ? INT64_MIN : -(int64_t)magnitude);
+    }
+    else {
+        return FromRaw(magnitude >= (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)magnitude);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Functions
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+inline Fixed sqrt(Fixed v) {
+    if (v.Raw() <= 0) return Fixed();
+
+    // The root of raw 2^32 is the raw root.  Work through the 96 bits of raw 2^32 two at a
+    // time from the top, bringing down the 64 bits of the raw value and then 32 zero bits.
+    uint64_t raw = (uint64_t)v.Raw();
+    uint64_t root = 0;
+    uint64_t remainder = 0;
+
+    for (int i = 0; i < 48; i++) {
+        int shift = 62 - 2 * i;
+        uint64_t bits = shift >= 0 ? (raw >> shift) & 3 : 0;
+
+        remainder = (remainder << 2) | bits;
+
+        uint64_t trial = (root << 2) | 1;
+        root <<= 1;
+
+        if (remainder >= trial) {
+            remainder -= trial;
+            root |= 1;
+        }
+    }
+
+    return Fixed::FromRaw((int64_t)root);
+}
+
+inline Fixed fabs(Fixed v) {
+    return v < Fixed() ? -v : v;
+}
+
+inline std::ostream& operator<<(std::ostream& os, Fixed v) {
+    return (os << (double)v);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Vectors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// The reciprocal of a large magnitude has few significant bits in fixed point, so divide each
+// component instead of multiplying by it
+template <>
+inline void Vec3T<Fixed>::Normalize() {
+    Fixed magnitude = Magnitude();
+
+    if (magnitude <= Fixed()) {
+        return;
+    }
+
+    _v[X] /= magnitude;
+    _v[Y] /= magnitude;
+    _v[Z] /= magnitude;
+}
+
+template <>
+inline void Vec2T<Fixed>::Normalize() {
+    Fixed magnitude = Magnitude();
+
+    if (magnitude <= Fixed()) {
+        return;
+    }
+
+    _v[X] /= magnitude;
+    _v[Y] /= magnitude;
+}
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        JointPolicies.h
+//
+// Author:      David Borland
+//
+// Description: Joint order and joint placement as policy types, named for the values of
+//              QuIK::JointOrderType and QuIK::JointPlacementType they stand for and kept in
+//              the JointPolicies namespace apart from those values.  QuIK's solver is
+//              instantiated for each, so it chooses them once per solve instead of once per
+//              joint, and QuIK::SolveIKWith<Order, Placement>() takes them directly, as in
+//              SolveIKWith<JointPolicies::DividingJointOrder,
+//              JointPolicies::TriangulationJointPlacement>().
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef JOINTPOLICIES_H
+#define JOINTPOLICIES_H
+
+
+#include "QuIK.h"
+#include "ChainReach.h"
+#include "VecN.h"
+
+
+namespace JointPolicies {
+
+
+// Joint orders, picking the joint to place in an interval that has no priority in it
+struct IncreasingJointOrder {
+    static const QuIK::JointOrderType Type = QuIK::IncreasingJointOrder;
+
+    static int Pick(int start, int) { return start + 1; }
+};
+
+struct DecreasingJointOrder {
+    static const QuIK::JointOrderType Type = QuIK::DecreasingJointOrder;
+
+    static int Pick(int, int end) { return end - 1; }
+};
+
+struct DividingJointOrder {
+    static const QuIK::JointOrderType Type = QuIK::DividingJointOrder;
+
+    static int Pick(int start, int end) { return (start + end) / 2; }
+};
+
+
+// Joint placements, computing the new position for the current joint in any dimension
+struct TriangulationJointPlacement {
+    static const QuIK::JointPlacementType Type = QuIK::TriangulationJointPlacement;
+
+    template <class Vec, class T>
+    static Vec Place(const Vec* joints, const ChainReachT<T>& reach, int start, int current, int end) {
+        return QuIKT<T, Vec::Dimension>::PlaceJointTriangulation(joints[current], joints[start], joints[end],
+                                                                 reach.MaxRadius(start, current), reach.MaxRadius(end, current));
+    }
+};
+
+struct InertialJointPlacement {
+    static const QuIK::JointPlacementType Type = QuIK::InertialJointPlacement;
+
+    template <class Vec, class T>
+    static Vec Place(const Vec* joints, const ChainReachT<T>& reach, int start, int current, int end) {
+        return QuIKT<T, Vec::Dimension>::PlaceJointInertial(joints[current], joints[start], joints[end],
+                                                            reach.MaxRadius(start, current), reach.MinRadius(start, current),
+                                                            reach.MaxRadius(end, current), reach.MinRadius(end, current));
+    }
+};
+
+
+} // namespace JointPolicies
+
+
+#endif
\ No newline at end of file
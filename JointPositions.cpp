@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        JointPositions.cpp
+//
+// Author:      David Borland
+//
+// Description: Joint positions of a bone chain, stored as a separate aligned array for each
+//              component, with an array of vectors kept alongside.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "JointPositions.h"
+
+#include "Fixed.h"
+
+#include <cmath>
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+JointPositionsT<T, D>::JointPositionsT() : arraysValid(true), viewValid(true) {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Number of joints
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+int JointPositionsT<T, D>::GetNumJoints() const {
+    return arraysValid ? components[0].size() : view.size();
+}
+
+template <class T, int D>
+void JointPositionsT<T, D>::Resize(int numJoints) {
+    UpdateArrays();
+
+    for (int d = 0; d < D; d++) {
+        components[d].resize(numJoints, T(0));
+    }
+
+    viewValid = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+VecT<T, D> JointPositionsT<T, D>::Get(int i) const {
+    if (!arraysValid) return view[i];
+
+    Vec position;
+    for (int d = 0; d < D; d++) {
+        position[d] = components[d][i];
+    }
+
+    return position;
+}
+
+template <class T, int D>
+void JointPositionsT<T, D>::Set(int i, const Vec& position) {
+    if (arraysValid) {
+        for (int d = 0; d < D; d++) {
+            components[d][i] = position[d];
+        }
+    }
+
+    if (viewValid) {
+        view[i] = position;
+    }
+}
+
+template <class T, int D>
+void JointPositionsT<T, D>::Set(const std::vector<Vec>& positions) {
+    view = positions;
+    viewValid = true;
+    arraysValid = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Editing
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+void JointPositionsT<T, D>::Insert(int i, const Vec& position) {
+    UpdateArrays();
+
+    for (int d = 0; d < D; d++) {
+        components[d].insert(components[d].begin() + i, position[d]);
+    }
+
+    viewValid = false;
+}
+
+template <class T, int D>
+void JointPositionsT<T, D>::Erase(int i) {
+    UpdateArrays();
+
+    for (int d = 0; d < D; d++) {
+        components[d].erase(components[d].begin() + i);
+    }
+
+    viewValid = false;
+}
+
+template <class T, int D>
+void JointPositionsT<T, D>::Translate(int first, const Vec& v) {
+    UpdateArrays();
+
+    int numJoints = components[0].size();
+
+    for (int d = 0; d < D; d++) {
+        T* p = components[d].data();
+        T vd = v[d];
+
+        for (int i = first; i < numJoints; i++) {
+            p[i] += vd;
+        }
+    }
+
+    viewValid = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Lengths
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+void JointPositionsT<T, D>::GetLengths(std::vector<T>& lengths) {
+    using std::sqrt;
+
+    UpdateArrays();
+
+    int numBones = (int)components[0].size() - 1;
+    if (numBones < 0) numBones = 0;
+
+    lengths.resize(numBones);
+
+    const T* p[D];
+    for (int d = 0; d < D; d++) {
+        p[d] = components[d].data();
+    }
+    T* l = lengths.data();
+
+    // The same arithmetic as the vector's Distance(), summing the squares in order
+    for (int i = 0; i < numBones; i++) {
+        T delta = p[0][i] - p[0][i + 1];
+        T sum = delta * delta;
+
+        for (int d = 1; d < D; d++) {
+            delta = p[d][i] - p[d][i + 1];
+            sum += delta * delta;
+        }
+
+        l[i] = sqrt(sum);
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Array of vectors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+const std::vector<VecT<T, D> >& JointPositionsT<T, D>::GetView() {
+    UpdateView();
+
+    return view;
+}
+
+template <class T, int D>
+VecT<T, D>* JointPositionsT<T, D>::EditView() {
+    UpdateView();
+
+    if (arraysValid) arraysValid = false;
+
+    return view.data();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Refresh
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+void JointPositionsT<T, D>::UpdateView() {
+    if (viewValid) return;
+
+    int numJoints = components[0].size();
+
+    view.resize(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        for (int d = 0; d < D; d++) {
+            view[i][d] = components[d][i];
+        }
+    }
+
+    viewValid = true;
+}
+
+template <class T, int D>
+void JointPositionsT<T, D>::UpdateArrays() {
+    if (arraysValid) return;
+
+    int numJoints = view.size();
+
+    for (int d = 0; d < D; d++) {
+        components[d].resize(numJoints);
+        for (int i = 0; i < numJoints; i++) {
+            components[d][i] = view[i][d];
+        }
+    }
+
+    arraysValid = true;
+}
+
+
+template class JointPositionsT<float, 2>;
+template class JointPositionsT<double, 2>;
+template class JointPositionsT<Fixed, 2>;
+template class JointPositionsT<float, 3>;
+template class JointPositionsT<double, 3>;
+template class JointPositionsT<Fixed, 3>;
\ No newline at end of file
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        JointPositions.h
+//
+// Author:      David Borland
+//
+// Description: Joint positions of a bone chain, stored as a separate aligned array for each
+//              component so loops over the whole chain can use SIMD instructions.  An array
+//              of vectors is kept alongside for callers that want one and for placing joints,
+//              which reads a few joints at scattered indices.  Each form is refreshed from
+//              the other only when it is needed after the other has changed.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef JOINTPOSITIONS_H
+#define JOINTPOSITIONS_H
+
+
+#include "VecN.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <new>
+#include <vector>
+
+
+// Allocator for std::vector that aligns the data for SIMD loads
+template <class T, size_t Alignment>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() {}
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        // Over allocate, and keep the original pointer just before the aligned data
+        char* p = (char*)::operator new(n * sizeof(T) + Alignment + sizeof(void*));
+        char* aligned = (char*)(((uintptr_t)p + sizeof(void*) + Alignment - 1) & ~(uintptr_t)(Alignment - 1));
+        ((void**)aligned)[-1] = p;
+
+        return (T*)aligned;
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(((void**)p)[-1]);
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+
+template <class T, int D = 3>
+class JointPositionsT {
+public:
+    typedef VecT<T, D> Vec;
+
+    // Constructor
+    JointPositionsT();                              // No joints
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Number of joints
+    int GetNumJoints() const;
+    void Resize(int numJoints);                     // Keeps existing joints, new joints at the origin
+
+
+    // Element access
+    Vec Get(int i) const;
+    void Set(int i, const Vec& position);
+    void Set(const std::vector<Vec>& positions);    // Replace all joints
+
+
+    // Editing
+    void Insert(int i, const Vec& position);
+    void Erase(int i);
+    void Translate(int first, const Vec& v);        // Add v to joint first and all after it
+
+
+    // Distance between each joint and the next, one fewer than the number of joints
+    void GetLengths(std::vector<T>& lengths);
+
+
+    // Array of vectors to read
+    const std::vector<Vec>& GetView();
+
+    // Array of vectors to place joints in.  The component arrays are refreshed from it when 
+    // next needed.  Only the first call after the component arrays change writes to this 
+    // object, so threads may call it at the same time after that.
+    Vec* EditView();
+
+
+    // Component arrays
+    typedef std::vector<T, AlignedAllocator<T, 32> > Array;
+
+protected:
+    // Refresh one form from the other
+    void UpdateView();
+    void UpdateArrays();
+
+    // The internal representation, at least one of which is current
+    Array components[D];
+    bool arraysValid;
+
+    std::vector<Vec> view;
+    bool viewValid;
+};
+
+
+typedef JointPositionsT<double> JointPositions;
+
+
+#endif
\ No newline at end of file
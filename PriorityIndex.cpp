@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        PriorityIndex.cpp
+//
+// Author:      David Borland
+//
+// Description: Pending joint priorities, indexed by joint so the highest-ranked priority 
+//              inside an interval of joints can be found in logarithmic time.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#include "PriorityIndex.h"
+
+#include <algorithm>
+#include <limits.h>
+
+
+// Rank of joints without a priority
+static const int NoRank = INT_MAX;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+PriorityIndex::PriorityIndex() {
+    _numLeaves = 0;
+    _numPending = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Capacity
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void PriorityIndex::Reserve(int numJoints, int numPriorities) {
+    _joints.reserve(numPriorities);
+
+    if (numJoints <= _numLeaves) return;
+
+    // Start over with a bigger tree
+    Clear();
+
+    _numLeaves = 1;
+    while (_numLeaves < numJoints) {
+        _numLeaves *= 2;
+    }
+
+    _tree.assign(2 * _numLeaves, NoRank);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void PriorityIndex::Clear() {
+    // Only need to reset the joints that were added
+    for (int i = 0; i < (int)_joints.size(); i++) {
+        Remove(_joints[i]);
+    }
+
+    _joints.clear();
+    _numPending = 0;
+}
+
+void PriorityIndex::Add(int joint) {
+    // Joints outside the tree can never be inside an interval being solved
+    if (joint < 0 || joint >= _numLeaves) return;
+
+    // Keep the first rank for duplicates
+    if (_tree[_numLeaves + joint] != NoRank) return;
+
+    SetRank(joint, _joints.size());
+
+    _joints.push_back(joint);
+    _numPending++;
+}
+
+void PriorityIndex::Remove(int joint) {
+    if (joint < 0 || joint >= _numLeaves) return;
+    if (_tree[_numLeaves + joint] == NoRank) return;
+
+    SetRank(joint, NoRank);
+
+    _numPending--;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Queries
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+int PriorityIndex::GetNumPending() const {
+    return _numPending;
+}
+
+int PriorityIndex::First(int start, int end) const {
+    if (_numPending == 0) return -1;
+
+    // Leaves strictly inside the interval, as a half-open range
+    int left = std::max(start + 1, 0) + _numLeaves;
+    int right = std::min(end, _numLeaves) + _numLeaves;
+
+    // Walk up the tree, taking the lowest rank of each node that is completely inside
+    int rank = NoRank;
+    while (left < right) {
+        if (left & 1) rank = std::min(rank, _tree[left++]);
+        if (right & 1) rank = std::min(rank, _tree[--right]);
+
+        left /= 2;
+        right /= 2;
+    }
+
+    return rank == NoRank ? -1 : _joints[rank];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Tree
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void PriorityIndex::SetRank(int joint, int rank) {
+    int node = _numLeaves + joint;
+    _tree[node] = rank;
+
+    for (node /= 2; node > 0; node /= 2) {
+        _tree[node] = std::min(_tree[2 * node], _tree[2 * node + 1]);
+    }
+}
\ No newline at end of file
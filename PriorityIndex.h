@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        PriorityIndex.h
+//
+// Author:      David Borland
+//
+// Description: Pending joint priorities, indexed by joint so the highest-ranked priority 
+//              inside an interval of joints can be found in logarithmic time.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#ifndef PRIORITYINDEX_H
+#define PRIORITYINDEX_H
+
+
+#include <vector>
+
+
+class PriorityIndex {
+public:
+    // Constructor
+    PriorityIndex();                                // No joints
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Make room for joints 0 to numJoints - 1 and the given number of priorities.  Only 
+    // grows, never shrinks.
+    void Reserve(int numJoints, int numPriorities);
+
+
+    // Remove all priorities
+    void Clear();
+
+    // Add a priority for a joint, ranked after all priorities added since the last clear.
+    // Joints that already have a priority keep their original rank.
+    void Add(int joint);
+
+    // Remove the priority for a joint
+    void Remove(int joint);
+
+
+    // Number of priorities not yet removed
+    int GetNumPending() const;
+
+    // Joint with the highest-ranked priority strictly between start and end, or -1 if none
+    int First(int start, int end) const;
+
+protected:
+    // Set a joint's rank and update the tree
+    void SetRank(int joint, int rank);
+
+
+    // Number of leaves in the tree, a power of two
+    int _numLeaves;
+
+    // Binary tree of the lowest rank in each range of joints, with the joints as leaves
+    std::vector<int> _tree;
+
+    // Joint for each rank
+    std::vector<int> _joints;
+
+    int _numPending;
+};
+
+
+#endif
\ No newline at end of file
@@ -11,19 +11,46 @@
 
 #include "QuIK.h"
 
+#include "JointPolicies.h"
 #include "SphereInterior.h"
 #include "SphereExterior.h"
+#include "SphereShell.h"
 
 #include <math.h>
 
+#include <algorithm>
 
-QuIK::QuIK() {
+
+// SSE2 is part of x86-64, so it is used whenever the compiler targets it
+#if defined(__SSE2__) || defined(_M_X64)
+#define QUIK_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+template <class T, int D>
+QuIKT<T, D>::QuIKT() {
     jointOrderType = IncreasingJointOrder;
     jointPlacementType = TriangulationJointPlacement;
+    traceLevel = JointOrderTrace;
+
+    solveType = SinglePassSolve;
+    executionType = SerialExecution;
+    updateType = FullUpdate;
+    grainSize = 512;
+    threadPool = NULL;
+
+    resolvePath = NULL;
+
+    radiiTablesValid = false;
 }
 
 
-void QuIK::SetBones(const std::vector<double>& boneLengths) {    
+template <class T, int D>
+void QuIKT<T, D>::SetBones(const std::vector<T>& boneLengths) {    
+    // Replace any joints still to be placed by a lazy update
+    workspace.lazyPending = false;
+
     // Copy the bone lengths
     int numBones = boneLengths.size();
 
@@ -36,9 +63,13 @@ void QuIK::SetBones(const std::vector<double>& boneLengths) {
     // Create initial positions
     int numJoints = numBones + 1;
 
-    positions.resize(numJoints);
+    positions.Resize(numJoints);
     for (int i = 1; i < numJoints; i++) {
-        positions[i] = positions[i - 1] + Vec3(lengths[i - 1], 0.0, 0.0);
+        // Along the x axis
+        Vec bone;
+        bone[0] = lengths[i - 1];
+
+        positions.Set(i, positions.Get(i - 1) + bone);
     }
 
 
@@ -46,204 +77,365 @@ void QuIK::SetBones(const std::vector<double>& boneLengths) {
     targetJoint = numJoints - 1;
 
 
+    // The plan depends on the number of joints
+    plan.Invalidate();
+
+
     // Create radii data structures
     CreateRadii();
 }
 
-void QuIK::SetJoints(const std::vector<Vec3>& jointPositions) {
+template <class T, int D>
+void QuIKT<T, D>::SetJoints(const std::vector<Vec>& jointPositions) {
+    // Replace any joints still to be placed by a lazy update
+    workspace.lazyPending = false;
+
     // Copy the joint positions
     int numJoints = jointPositions.size();
 
-    positions.resize(numJoints);
-    for (int i = 0; i < numJoints; i++) {
-        positions[i] = jointPositions[i];
-    }
+    positions.Set(jointPositions);
 
 
     // Compute the bone lengths
-    int numBones = numJoints - 1;
-
-    lengths.resize(numBones);
-    for (int i = 0; i < numBones; i++) {
-        lengths[i] = positions[i].Distance(positions[i + 1]);
-    }
+    positions.GetLengths(lengths);
 
 
     // Set the initial target joint
     targetJoint = numJoints - 1;
 
 
+    // The plan depends on the number of joints
+    plan.Invalidate();
+
+
     // Create radii data structures
     CreateRadii();
 }
 
 
-void QuIK::AddJoint(int jointIndex, Vec3 position) {
+template <class T, int D>
+void QuIKT<T, D>::AddJoint(int jointIndex, Vec position) {
+    // Place any joints still to be placed by a lazy update
+    ResolveJoints();
+
     // Get vector from previous joint to the new joint
-    Vec3 v = position - positions[jointIndex - 1];
+    Vec v = position - positions.Get(jointIndex - 1);
 
     // Add the joint
-    positions.insert(positions.begin() + jointIndex, position);
+    positions.Insert(jointIndex, position);
 
     // Add the vector to all joints in front of this one
-    for (int i = jointIndex + 1; i < (int)positions.size(); i++) {
-        positions[i] += v;
-    }
+    positions.Translate(jointIndex + 1, v);
 
-    // Add a bone
-    lengths.push_back(1.0);
+    plan.Invalidate();
 
-    // Update bone lengths
-    for (int i = 0; i < (int)lengths.size(); i++) {
-        lengths[i] = positions[i].Distance(positions[i + 1]);
-    }
+    // Update bone lengths, adding a bone
+    positions.GetLengths(lengths);
 
     // Update radii
     CreateRadii();
 }
 
-void QuIK::DeleteJoint(int jointIndex) {
+template <class T, int D>
+void QuIKT<T, D>::DeleteJoint(int jointIndex) {
+    // Place any joints still to be placed by a lazy update
+    ResolveJoints();
+
     // Get vector from next joint to this joint
-    Vec3 v = positions[jointIndex] - positions[jointIndex + 1];
+    Vec v = positions.Get(jointIndex) - positions.Get(jointIndex + 1);
 
     // Delete the joint
-    positions.erase(positions.begin() + jointIndex);
+    positions.Erase(jointIndex);
 
     // Add the vector to all joints in front of this one
-    for (int i = jointIndex; i < (int)positions.size(); i++) {
-        positions[i] += v;
-    }
+    positions.Translate(jointIndex, v);
 
-    // Delete a bone
-    lengths.pop_back();
+    plan.Invalidate();
 
-    // Update bone lengths
-    for (int i = 0; i < (int)lengths.size(); i++) {
-        lengths[i] = positions[i].Distance(positions[i + 1]);
-    }
+    // Update bone lengths, deleting a bone
+    positions.GetLengths(lengths);
 
     // Update radii
     CreateRadii();
 }
 
-void QuIK::SetJointPosition(int jointIndex, Vec3 position) {
+template <class T, int D>
+void QuIKT<T, D>::SetJointPosition(int jointIndex, Vec position) {
+    // Place any joints still to be placed by a lazy update
+    ResolveJoints();
+
     // Get vector from current to new position
-    Vec3 v = position - positions[jointIndex];
+    Vec v = position - positions.Get(jointIndex);
 
     // Update the position
-    positions[jointIndex] = position;
+    positions.Set(jointIndex, position);
 
     // Add the vector to all joints in front of this one
-    for (int i = jointIndex + 1; i < (int)positions.size(); i++) {
-        positions[i] += v;
-    }
+    positions.Translate(jointIndex + 1, v);
 
     // Update bone lengths
-    for (int i = 0; i < (int)lengths.size(); i++) {
-        lengths[i] = positions[i].Distance(positions[i + 1]);
-    }
+    positions.GetLengths(lengths);
 
     // Update radii
     CreateRadii();
 }
 
 
-int QuIK::GetTargetJoint() {
+template <class T, int D>
+int QuIKT<T, D>::GetTargetJoint() {
     return targetJoint;
 }
 
-void QuIK::SetTargetJoint(int targetJointIndex) {
+template <class T, int D>
+void QuIKT<T, D>::SetTargetJoint(int targetJointIndex) {
+    if (targetJointIndex != targetJoint) plan.Invalidate();
+
     targetJoint = targetJointIndex;;
 
-    SetTarget(positions[targetJoint]);
+    ResolveJoint(targetJoint);
+    SetTarget(positions.Get(targetJoint));
 }
 
-const Vec3& QuIK::GetTarget() {
+template <class T, int D>
+const VecT<T, D>& QuIKT<T, D>::GetTarget() {
     return target;
 }
 
-void QuIK::SetTarget(const Vec3& targetPosition) {
+template <class T, int D>
+void QuIKT<T, D>::SetTarget(const Vec& targetPosition) {
     // Set the new target position
     target = targetPosition;
 }
 
 
-void QuIK::SolveIK() {
-    // Set the target joint to the target
-    if (targetJoint == positions.size() - 1) {
-        // Set the last joint position as close as possible to the target
-        SphereInterior maxSphere(positions[0], maxRadii[0][positions.size() - 1]);
-        SphereExterior minSphere(positions[0], minRadii[0][positions.size() - 1]);
+template <class T, int D>
+void QuIKT<T, D>::SolveIK() {
+    // Choose the joint order and placement once
+    switch (jointOrderType) {
 
-        Vec3 p1 = maxSphere.ClosestPoint(target);
-        Vec3 p2 = minSphere.ClosestPoint(target);
+        case IncreasingJointOrder:
 
-        if (positions.back().Distance(p1) < positions.back().Distance(p2) &&
-            positions[0].Distance(p1) >= minRadii[0][positions.size() - 1]) {
-            positions.back() = p1;
-        }
-        else {
-            positions.back() = p2;
-        }
+            SolveTarget<JointPolicies::IncreasingJointOrder>();
+
+            break;
+
+        case DecreasingJointOrder:
+
+            SolveTarget<JointPolicies::DecreasingJointOrder>();
+
+            break;
+
+        case DividingJointOrder:
+
+            SolveTarget<JointPolicies::DividingJointOrder>();
+
+            break;
     }
-    else {
-        positions[targetJoint] = target;
+}
+
+template <class T, int D>
+template <class Order, class Placement>
+void QuIKT<T, D>::SolveIKWith() {
+    SetJointOrderType((JointOrderType)Order::Type);
+    SetJointPlacementType((JointPlacementType)Placement::Type);
+
+    SolveTarget<Order, Placement>();
+}
+
+template <class T, int D>
+void QuIKT<T, D>::SolveIK(const Vec* targets, int numTargets, Vec* poses) {
+    if (numTargets <= 0) return;
+
+    // Place any joints still to be placed by a lazy update, which each target starts from
+    ResolveJoints();
+
+    // Compile the order of joint placement, if necessary
+    if (!plan.IsValid()) {
+        CompilePlan();
     }
 
+    ThreadPool& pool = threadPool ? *threadPool : ThreadPool::GetGlobal();
 
-    // Set the priorities
-    tempPriorities.resize(priorities.size());
-    bool foundTargetJoint = false;
-    for (int i = 0; i < (int)priorities.size(); i++) {
-        tempPriorities[i] = priorities[i];
+    // Refresh the array of vectors before the tasks read it
+    positions.GetView();
+
+    // A few tasks per thread, with at least the grain size of joint placements per task
+    int numTasks = 4 * (pool.GetNumThreads() + 1);
+    int targetsPerTask = (numTargets + numTasks - 1) / numTasks;
+
+    int minTargets = grainSize / (plan.GetNumPlacements() + 1);
+    if (targetsPerTask < minTargets) targetsPerTask = minTargets;
+
+    // Choose the joint placement once for all of the targets
+    ThreadPool::TaskFunction solveTargets = NULL;
+    switch (jointPlacementType) {
+
+        case TriangulationJointPlacement:
+
+            solveTargets = SolveTargetsTask<JointPolicies::TriangulationJointPlacement>;
 
-        if (tempPriorities[i] == targetJoint) foundTargetJoint = true;
+            break;
+
+        case InertialJointPlacement:
+
+            solveTargets = SolveTargetsTask<JointPolicies::InertialJointPlacement>;
+
+            break;
     }
-    
-    // Add target joint, if necessary
-    if (!foundTargetJoint) {
-        tempPriorities.push_back(targetJoint);
+
+    TargetTasks tasks;
+    tasks.ik = this;
+    tasks.targets = targets;
+    tasks.numTargets = numTargets;
+    tasks.targetsPerTask = targetsPerTask;
+    tasks.poses = poses;
+
+    numTasks = (numTargets + targetsPerTask - 1) / targetsPerTask;
+
+    if (numTasks == 1) {
+        solveTargets(&tasks, 0);
     }
+    else {
+        ThreadPool::TaskGroup group;
 
+        for (int i = 0; i < numTasks; i++) {
+            pool.Run(group, solveTargets, &tasks, i);
+        }
 
-    // Clear the joint order vectors
-    startOrder.clear();
-    currentOrder.clear();
-    endOrder.clear();
+        pool.Wait(group);
+    }
+}
 
+template <class T, int D>
+void QuIKT<T, D>::SolveIK(const std::vector<Vec>& targets, std::vector<Vec>& poses) {
+    poses.resize(targets.size() * positions.GetNumJoints());
 
-    // Update the IK
-    SolveIK(0, positions.size() - 1);
-//    SolveIK(0, targetJoint);
-//    SolveIK(targetJoint, positions.size() - 1);
+    if (targets.empty()) return;
+
+    SolveIK(&targets[0], targets.size(), &poses[0]);
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::SolveTargetsTask(void* data, int task) {
+    TargetTasks* tasks = (TargetTasks*)data;
+    QuIKT* ik = tasks->ik;
+
+    const std::vector<Vec>& positions = ik->positions.GetView();
+    int numJoints = positions.size();
+
+    int first = task * tasks->targetsPerTask;
+    int last = std::min(first + tasks->targetsPerTask, tasks->numTargets);
+
+    for (int i = first; i < last; i++) {
+        // Start from the current joint positions
+        Vec* joints = tasks->poses + (size_t)i * numJoints;
+        std::copy(positions.begin(), positions.end(), joints);
+
+        ik->PlaceTargetJoint(joints, tasks->targets[i]);
+        ik->template PlaceJoints<Placement>(joints);
+    }
+}
+
+
+template <class T, int D>
+typename QuIKT<T, D>::SolveType QuIKT<T, D>::GetSolveType() {
+    return solveType;
 }
 
+template <class T, int D>
+void QuIKT<T, D>::SetSolveType(SolveType type) {
+    if (type != solveType) plan.Invalidate();
 
-QuIK::JointOrderType QuIK::GetJointOrderType() {
+    solveType = type;
+}
+
+
+template <class T, int D>
+typename QuIKT<T, D>::ExecutionType QuIKT<T, D>::GetExecutionType() {
+    return executionType;
+}
+
+template <class T, int D>
+void QuIKT<T, D>::SetExecutionType(ExecutionType type) {
+    executionType = type;
+}
+
+template <class T, int D>
+typename QuIKT<T, D>::UpdateType QuIKT<T, D>::GetUpdateType() {
+    return updateType;
+}
+
+template <class T, int D>
+void QuIKT<T, D>::SetUpdateType(UpdateType type) {
+    updateType = type;
+}
+
+template <class T, int D>
+int QuIKT<T, D>::GetGrainSize() {
+    return grainSize;
+}
+
+template <class T, int D>
+void QuIKT<T, D>::SetGrainSize(int size) {
+    grainSize = size;
+}
+
+template <class T, int D>
+void QuIKT<T, D>::SetThreadPool(ThreadPool* pool) {
+    threadPool = pool;
+}
+
+
+template <class T, int D>
+typename QuIKT<T, D>::JointOrderType QuIKT<T, D>::GetJointOrderType() {
     return jointOrderType;
 }
 
-void QuIK::SetJointOrderType(QuIK::JointOrderType type) {
+template <class T, int D>
+void QuIKT<T, D>::SetJointOrderType(JointOrderType type) {
+    if (type != jointOrderType) plan.Invalidate();
+
     jointOrderType = type;
 }
 
 
-QuIK::JointPlacementType QuIK::GetJointPlacementType() {
+template <class T, int D>
+typename QuIKT<T, D>::JointPlacementType QuIKT<T, D>::GetJointPlacementType() {
     return jointPlacementType;
 }
 
-void QuIK::SetJointPlacementType(QuIK::JointPlacementType type) {
+template <class T, int D>
+void QuIKT<T, D>::SetJointPlacementType(JointPlacementType type) {
     jointPlacementType = type;
 }
 
 
-void  QuIK::ClearPriorities() {
+template <class T, int D>
+typename QuIKT<T, D>::TraceLevel QuIKT<T, D>::GetTraceLevel() {
+    return traceLevel;
+}
+
+template <class T, int D>
+void QuIKT<T, D>::SetTraceLevel(TraceLevel level) {
+    // The trace is recorded when compiling the plan
+    if (level != traceLevel) plan.Invalidate();
+
+    traceLevel = level;
+}
+
+
+template <class T, int D>
+void  QuIKT<T, D>::ClearPriorities() {
     priorities.clear();
+
+    plan.Invalidate();
 }
 
-void  QuIK::AddPriority(int jointIndex) {
+template <class T, int D>
+void  QuIKT<T, D>::AddPriority(int jointIndex) {
     // Don't accept first or last indeces
-    if (jointIndex <= 0 || jointIndex >= (int)positions.size() - 1) return;
+    if (jointIndex <= 0 || jointIndex >= positions.GetNumJoints() - 1) return;
 
     // Make sure there is no duplicate
     for (int i = 0; i < (int)priorities.size(); i++) {
@@ -252,334 +444,783 @@ void  QuIK::AddPriority(int jointIndex) {
 
     // Add the joint index
     priorities.push_back(jointIndex);
+
+    plan.Invalidate();
 }
 
-void  QuIK::TogglePriority(int jointIndex) {
+template <class T, int D>
+void  QuIKT<T, D>::TogglePriority(int jointIndex) {
     // Don't accept first or last indeces
-    if (jointIndex <= 0 || jointIndex >= (int)positions.size() - 1) return;
+    if (jointIndex <= 0 || jointIndex >= positions.GetNumJoints() - 1) return;
 
     // If there, remove
     for (int i = 0; i < (int)priorities.size(); i++) {
         if (priorities[i] == jointIndex) {   
             priorities.erase(priorities.begin() + i);
 
+            plan.Invalidate();
+
             return;
         }
     }
 
     // If here, it was not found, so add the joint index
     priorities.push_back(jointIndex);
+
+    plan.Invalidate();
 }
 
 
-int QuIK::GetNumBones() {
+template <class T, int D>
+int QuIKT<T, D>::GetNumBones() {
     return lengths.size();
 }
 
-int QuIK::GetNumJoints() {
-    return positions.size();
+template <class T, int D>
+int QuIKT<T, D>::GetNumJoints() {
+    return positions.GetNumJoints();
 }
 
 
-const std::vector<double>& QuIK::GetLengths() {
+template <class T, int D>
+const std::vector<T>& QuIKT<T, D>::GetLengths() {
     return lengths;
 }
 
-const std::vector<Vec3>& QuIK::GetPositions() {
-    return positions;
+template <class T, int D>
+const std::vector<VecT<T, D> >& QuIKT<T, D>::GetPositions() {
+    ResolveJoints();
+
+    return positions.GetView();
 }
 
+template <class T, int D>
+VecT<T, D> QuIKT<T, D>::GetPosition(int jointIndex) {
+    ResolveJoint(jointIndex);
 
-const std::vector<int>& QuIK::GetPriorities() {
+    return positions.Get(jointIndex);
+}
+
+
+template <class T, int D>
+const std::vector<int>& QuIKT<T, D>::GetPriorities() {
     return priorities;
 }
 
 
-const std::vector<std::vector<double>>& QuIK::GetMaxRadii() {
+template <class T, int D>
+const ChainReachT<T>& QuIKT<T, D>::GetReach() {
+    return reach;
+}
+
+template <class T, int D>
+T QuIKT<T, D>::GetMaxRadius(int i, int j) {
+    return reach.MaxRadius(i, j);
+}
+
+template <class T, int D>
+T QuIKT<T, D>::GetMinRadius(int i, int j) {
+    return reach.MinRadius(i, j);
+}
+
+
+template <class T, int D>
+const std::vector<std::vector<T>>& QuIKT<T, D>::GetMaxRadii() {
+    CreateRadiiTables();
+
     return maxRadii;
 }
 
-const std::vector<std::vector<double>>& QuIK::GetMinRadii() {
+template <class T, int D>
+const std::vector<std::vector<T>>& QuIKT<T, D>::GetMinRadii() {
+    CreateRadiiTables();
+
     return minRadii;
 }
 
 
-const std::vector<int>& QuIK::GetStartOrder() {
-    return startOrder;
+template <class T, int D>
+const std::vector<int>& QuIKT<T, D>::GetStartOrder() {
+    return workspace.startOrder;
+}
+
+template <class T, int D>
+const std::vector<int>& QuIKT<T, D>::GetCurrentOrder() {
+    return workspace.currentOrder;
+}
+
+template <class T, int D>
+const std::vector<int>& QuIKT<T, D>::GetEndOrder() {
+    return workspace.endOrder;
+}
+
+
+template <class T, int D>
+int QuIKT<T, D>::GetNumPlacementsMade() {
+    return workspace.numPlaced;
 }
 
-const std::vector<int>& QuIK::GetCurrentOrder() {
-    return currentOrder;
+template <class T, int D>
+int QuIKT<T, D>::GetNumPlacementsSkipped() {
+    return workspace.numSkipped;
 }
 
-const std::vector<int>& QuIK::GetEndOrder() {
-    return endOrder;
+template <class T, int D>
+const SolvePlan& QuIKT<T, D>::GetPlan() {
+    if (!plan.IsValid()) {
+        CompilePlan();
+    }
+
+    return plan;
 }
 
 
-void QuIK::CreateRadii() {
+template <class T, int D>
+void QuIKT<T, D>::CreateRadii() {
+    // Create the reach from the bone lengths
+    reach.Set(lengths);
+
+    // Free the tables, they will be recreated if requested
+    maxRadii.clear();
+    minRadii.clear();
+    radiiTablesValid = false;
+
+    // Intervals settled with the old radii must be solved again
+    workspace.ForgetMoves();
+}
+
+template <class T, int D>
+void QuIKT<T, D>::CreateRadiiTables() {
+    if (radiiTablesValid) return;
+
     // One more joint than bones
-    int numJoints = positions.size();
+    int numJoints = positions.GetNumJoints();
 
     // One set of radii per joint
     maxRadii.resize(numJoints);
     minRadii.resize(numJoints);
 
-    // Create radii data structures
+    // Fill in from the reach
     for (int i = 0; i < numJoints; i++) {
-        // Set the number of joints
         maxRadii[i].resize(numJoints);
         minRadii[i].resize(numJoints);
 
-        // Initialize this joint
-        maxRadii[i][i] = 0.0;
-        minRadii[i][i] = 0.0;
-
-        // Initialize to the left, which must be a fixed distance
-        if (i > 0) {
-            maxRadii[i][i - 1] = lengths[i - 1];
-            minRadii[i][i - 1] = lengths[i - 1];
+        for (int j = 0; j < numJoints; j++) {
+            maxRadii[i][j] = reach.MaxRadius(i, j);
+            minRadii[i][j] = reach.MinRadius(i, j);
         }
+    }
 
-        // Initialize to the right, which must be a fixed distance
-        if (i < numJoints - 1) {
-            maxRadii[i][i + 1] = lengths[i];
-            minRadii[i][i + 1] = lengths[i];
-        }
+    radiiTablesValid = true;
+}
 
-        // Do the rest
-        for (int j = i - 2; j >= 0; j--) {
-            maxRadii[i][j] = maxRadii[i][j + 1] + lengths[j];
-            minRadii[i][j] = minRadii[i][j + 1] - lengths[j];
-        }
-        for (int j = i + 2; j < numJoints; j++) {
-            maxRadii[i][j] = maxRadii[i][j - 1] + lengths[j - 1];
-            minRadii[i][j] = minRadii[i][j - 1] - lengths[j - 1];
-        }
+
+template <class T, int D>
+void QuIKT<T, D>::CompilePlan() {
+    // Choose the joint order once
+    switch (jointOrderType) {
+
+        case IncreasingJointOrder:
+
+            CompilePlan<JointPolicies::IncreasingJointOrder>();
+
+            break;
+
+        case DecreasingJointOrder:
+
+            CompilePlan<JointPolicies::DecreasingJointOrder>();
+
+            break;
+
+        case DividingJointOrder:
+
+            CompilePlan<JointPolicies::DividingJointOrder>();
+
+            break;
     }
-/*
-    for (int i = 0; i < numJoints; i++) {
-        for (int j = 0; j < numJoints; j++) {
-            std::cout << maxRadii[i][j] << " ";
-        }
-        std::cout << std::endl;
+}
+
+template <class T, int D>
+template <class Order>
+void QuIKT<T, D>::CompilePlan() {
+    // Place any joints still to be placed by a lazy update with the old plan
+    ResolveJoints();
+
+    int numJoints = positions.GetNumJoints();
+
+    // Make sure the workspace is big enough, including the target joint as a priority
+    workspace.Reserve(numJoints, priorities.size() + 1);
+
+
+    // Set the priorities
+    workspace.priorities.Clear();
+
+    // Split around the target joint by placing it first
+    if (solveType == SplitSolve) {
+        workspace.priorities.Add(targetJoint);
     }
-    std::cout << std::endl;
-    for (int i = 0; i < numJoints; i++) {
-        for (int j = 0; j < numJoints; j++) {
-            std::cout << minRadii[i][j] << " ";
-        }
-        std::cout << std::endl;
+
+    bool foundTargetJoint = false;
+    for (int i = 0; i < (int)priorities.size(); i++) {
+        workspace.priorities.Add(priorities[i]);
+
+        if (priorities[i] == targetJoint) foundTargetJoint = true;
+    }
+    
+    // Add target joint, if necessary
+    if (!foundTargetJoint) {
+        workspace.priorities.Add(targetJoint);
     }
-*/
-}
 
 
-void QuIK::SolveIK(int start, int end) {
-    // Pick the current joint to place
-    int current = -1;
-    for (int i = 0; i < (int)tempPriorities.size(); i++) {
-        if (tempPriorities[i] > start && tempPriorities[i] < end) {
-            // Use this joint for current
-            current = tempPriorities[i];
+    // Clear the joint order vectors
+    workspace.startOrder.clear();
+    workspace.currentOrder.clear();
+    workspace.endOrder.clear();
 
-            // Remove from temp priorities
-            tempPriorities.erase(tempPriorities.begin() + i);
 
-            break;
-        }
-    }    
-    if (current == -1) {
-        // Pick current some other way
-        switch (jointOrderType) {
+    // Compile the whole chain
+    plan.Clear();
+    plan.Reserve(2 * numJoints);
+
+    CompilePlan<Order>(0, numJoints - 1);
 
-            case IncreasingJointOrder:
+    plan.Finish();
+
+    // Settled intervals were for the old plan
+    workspace.ForgetMoves();
+}
 
-                current = start + 1;
+template <class T, int D>
+template <class Order>
+void QuIKT<T, D>::CompilePlan(int start, int end) {
+    // Work through the intervals with an explicit stack instead of recursing, so the depth 
+    // of the solution does not depend on the call stack.  Pushing the second half first 
+    // places joints in the same order as the recursive solution.
+    std::vector<typename SolveWorkspace::Interval>& intervals = workspace.intervals;
+    intervals.clear();
+    intervals.push_back(typename SolveWorkspace::Interval(start, end));
 
-                break;
+    while (!intervals.empty()) {
+        typename SolveWorkspace::Interval interval = intervals.back();
+        intervals.pop_back();
 
-            case DecreasingJointOrder:
+        // Pick the current joint to place
+        int current = PickJoint<Order>(interval.start, interval.end);
 
-                current = end - 1;
 
-                break;
+        // Add to the plan
+        plan.Add(interval.start, current, interval.end);
 
-            case DividingJointOrder:
-        
-                current = (start + end) / 2;
 
-                break;
+        // Save the order 
+        if (traceLevel == JointOrderTrace) {
+            workspace.startOrder.push_back(interval.start);
+            workspace.currentOrder.push_back(current);
+            workspace.endOrder.push_back(interval.end);
         }
-    }    
-    
 
-    // Save the order 
-    startOrder.push_back(start);
-    currentOrder.push_back(current);
-    endOrder.push_back(end);
 
+        // Subdivide
+        if (interval.end - interval.start > 2) {
+            intervals.push_back(typename SolveWorkspace::Interval(current, interval.end));
+            intervals.push_back(typename SolveWorkspace::Interval(interval.start, current));
+        }
+    }
+}
+
+template <class T, int D>
+template <class Order>
+int QuIKT<T, D>::PickJoint(int start, int end) {
+    // Use the first priority inside the interval
+    int current = workspace.priorities.First(start, end);
+    if (current != -1) {
+        // Remove from the pending priorities
+        workspace.priorities.Remove(current);
+
+        return current;
+    }
+
+    // Pick current some other way
+    return Order::Pick(start, end);
+}
 
-    // Place the joint
+
+template <class T, int D>
+template <class Order>
+void QuIKT<T, D>::SolveTarget() {
+    // Choose the joint placement once
     switch (jointPlacementType) {
 
         case TriangulationJointPlacement:
 
-            PlaceJointTriangulation(start, current, end);
+            SolveTarget<Order, JointPolicies::TriangulationJointPlacement>();
 
             break;
 
         case InertialJointPlacement:
 
-            PlaceJointInertial(start, current, end);
+            SolveTarget<Order, JointPolicies::InertialJointPlacement>();
 
             break;
     }
+}
+
+template <class T, int D>
+template <class Order, class Placement>
+void QuIKT<T, D>::SolveTarget() {
+    // Start from the current joint positions, without placing joints a lazy update has not
+    workspace.lazyPending = false;
+
+    Vec* joints = positions.EditView();
+
+    // Set the target joint to the target
+    Vec previousTarget = joints[targetJoint];
+    PlaceTargetJoint(joints, target);
+
+
+    // Compile the order of joint placement, if necessary
+    if (!plan.IsValid()) {
+        CompilePlan<Order>();
+    }
+
+    if (joints[targetJoint] != previousTarget) {
+        workspace.MoveJoint(targetJoint);
+    }
 
 
-    // Recurse
-    if (end - start <= 2) {
+    // Update the IK
+    Solve<Placement>(joints);
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::Solve(Vec* joints) {
+    bool parallel = solveType == SplitSolve || 
+                    (executionType == ParallelExecution && jointOrderType == DividingJointOrder);
+
+    if (updateType == IncrementalUpdate && !parallel) {
+        UpdateJoints<Placement>(joints);
+
+        return;
+    }
+
+    // Joints are moved without being counted, so nothing stays settled
+    workspace.ForgetMoves();
+
+    if (updateType == LazyUpdate) {
+        // Make the placements when joints are requested
+        workspace.numPlaced = 0;
+        workspace.numSkipped = plan.GetNumPlacements();
+
+        workspace.numLazySolutions++;
+        workspace.lazyPending = plan.GetNumPlacements() > 0;
+        resolvePath = &QuIKT::template ResolvePath<Placement>;
+
+        return;
+    }
+
+    workspace.numPlaced = plan.GetNumPlacements();
+    workspace.numSkipped = 0;
+
+    if (parallel) {
+        SolveParallel<Placement>();
+
         return;
     }
+
+    PlaceJoints<Placement>(joints);
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::SolveParallel() {
+    ThreadPool& pool = threadPool ? *threadPool : ThreadPool::GetGlobal();
+
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+    for (int i = 0; i < plan.GetNumPlacements(); i += placements[i].size) {
+        SolveParallel<Placement>(pool, i, -1);
+    }
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::SolveParallel(ThreadPool& pool, int first, int deferred) {
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+    Vec* joints = positions.EditView();
+
+    // The start joint of the interval solved by a task can be read by the interval before it, 
+    // which is solved at the same time.  Nothing after the task reads it, so hold its new 
+    // position until the task that was solving the interval before it has finished.
+    int deferredJoint = deferred == -1 ? -1 : placements[deferred].start;
+
+    // Place joints serially for small intervals, or just the first joint for large 
+    // intervals.  The first interval of a split solve is subdivided for any joint order.
+    bool subdivide = placements[first].size >= grainSize &&
+                     ((executionType == ParallelExecution && jointOrderType == DividingJointOrder) ||
+                      (solveType == SplitSolve && first == 0));
+
+    int last = subdivide ? first + 1 : first + placements[first].size;
+    for (int i = first; i < last; i++) {
+        const SolvePlan::Placement& p = placements[i];
+
+        Vec position = Placement::Place(joints, reach, p.start, p.current, p.end);
+
+        if (p.current == deferredJoint) {
+            workspace.deferredPositions[deferred] = position;
+            workspace.deferred[deferred] = true;
+        }
+        else {
+            joints[p.current] = position;
+        }
+    }
+
+    if (last == first + placements[first].size) return;
+
+
+    // Solve the two halves of the interval
+    int firstHalf = first + 1;
+    int secondHalf = firstHalf + placements[firstHalf].size;
+
+    if (placements[firstHalf].writesEnd) {
+        // The second half depends on the first
+        SolveParallel<Placement>(pool, firstHalf, deferred);
+        SolveParallel<Placement>(pool, secondHalf, -1);
+    }
     else {
-        SolveIK(start, current);
-        SolveIK(current, end);
+        // Solve the second half in another task
+        ThreadPool::TaskGroup group;
+
+        workspace.deferred[secondHalf] = false;
+        pool.Run(group, SolveParallelTask<Placement>, this, secondHalf);
+
+        SolveParallel<Placement>(pool, firstHalf, deferred);
+
+        pool.Wait(group);
+
+        if (workspace.deferred[secondHalf]) {
+            joints[placements[secondHalf].start] = workspace.deferredPositions[secondHalf];
+        }
     }
 }
 
-void QuIK::PlaceJointTriangulation(int start, int current, int end) {
-    // Create max radii spheres
-    Sphere s1(positions[start], maxRadii[start][current]);
-    Sphere s2(positions[end], maxRadii[end][current]);
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::SolveParallelTask(void* data, int first) {
+    QuIKT* ik = (QuIKT*)data;
 
-    // Perform sphere-sphere intersection
-    Vec3 c;
-    double r;
-    Vec3 n;
-    Sphere::SSI_Type i = s1.Intersection(s2, c, r, n);
+    ik->template SolveParallel<Placement>(ik->threadPool ? *ik->threadPool : ThreadPool::GetGlobal(), first, first);
+}
 
-    // Set the position based on the sphere-sphere intersection
-    positions[current] = HandleSphereSphereIntersection(positions[current], i, c, r, n);
+
+template <class T, int D>
+void QuIKT<T, D>::PlaceTargetJoint(Vec* joints, const Vec& targetPosition) {
+    int last = positions.GetNumJoints() - 1;
+
+    if (targetJoint == last) {
+        joints[last] = PlaceLastJoint(joints[0], joints[last], targetPosition, reach.MaxRadius(0, last), reach.MinRadius(0, last));
+    }
+    else {
+        joints[targetJoint] = targetPosition;
+    }
 }
 
-void QuIK::PlaceJointInertial(int start, int current, int end) {
-    Vec3 p = positions[current];
+template <class T, int D>
+VecT<T, D> QuIKT<T, D>::PlaceLastJoint(const Vec& first, const Vec& last, const Vec& targetPosition, T maxRadius, T minRadius) {
+    // Set the last joint position as close as possible to the target
+    SphereInteriorT<T, D> maxSphere(first, maxRadius);
+    SphereExteriorT<T, D> minSphere(first, minRadius);
 
-    Vec3 c1 = positions[start];
-    Vec3 c2 = positions[end];
+    Vec p1 = maxSphere.ClosestPoint(targetPosition);
+    Vec p2 = minSphere.ClosestPoint(targetPosition);
+
+    // p1 can lie exactly on the minimum radius, where squaring rounds differently than 
+    // the projection onto the sphere did, so keep the distance for that test
+    if (last.DistanceSquared(p1) < last.DistanceSquared(p2) &&
+        first.Distance(p1) >= minRadius) {
+        return p1;
+    }
+    else {
+        return p2;
+    }
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::PlaceJoints(Vec* joints) {
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+    int numPlacements = plan.GetNumPlacements();
+
+    for (int i = 0; i < numPlacements; i++) {
+        joints[placements[i].current] = Placement::Place(joints, reach, placements[i].start, placements[i].current, placements[i].end);
+    }
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::UpdateJoints(Vec* joints) {
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+    int numPlacements = plan.GetNumPlacements();
+
+    // An interval only reads and writes the joints from its start to its end, and its inner 
+    // joints are only written by its own placements, apart from the target joint.  If none 
+    // of them moved the last time it was solved, and its start, end and target joint have not 
+    // moved since, solving it again would move nothing.
+    std::vector<typename SolveWorkspace::OpenPlacement>& open = workspace.open;
+    open.clear();
+
+    workspace.numPlaced = 0;
+    workspace.numSkipped = 0;
+
+    int i = 0;
+    while (true) {
+        // Finish the intervals that end here, which are settled if nothing moved in them
+        while (!open.empty() && open.back().end == i) {
+            const typename SolveWorkspace::OpenPlacement& o = open.back();
+
+            workspace.settled[o.placement] = o.moves == workspace.numMoves ? o.moves : 0;
+            open.pop_back();
+        }
+
+        if (i == numPlacements) break;
 
-    Vec3 v1 = p - c1;
-    Vec3 v2 = p - c2;
-    double d1 = v1.Magnitude();
-    double d2 = v2.Magnitude();
 
-    double rMax1 = maxRadii[start][current];
-    double rMin1 = minRadii[start][current];
+        const SolvePlan::Placement& p = placements[i];
+
+        // Skip a settled interval
+        unsigned long long settled = workspace.settled[i];
+
+        if (settled >= workspace.firstMove && 
+            workspace.jointMoves[p.start] <= settled && 
+            workspace.jointMoves[p.end] <= settled &&
+            (targetJoint <= p.start || targetJoint >= p.end || workspace.jointMoves[targetJoint] <= settled)) {
+            workspace.numSkipped += p.size;
+            i += p.size;
+
+            continue;
+        }
+
+
+        // Place the joint, counting it if it moves
+        open.push_back(typename SolveWorkspace::OpenPlacement(i, i + p.size, workspace.numMoves));
+
+        Vec position = Placement::Place(joints, reach, p.start, p.current, p.end);
+
+        if (position != joints[p.current]) {
+            joints[p.current] = position;
+            workspace.MoveJoint(p.current);
+        }
+
+        workspace.numPlaced++;
+        i++;
+    }
+}
 
-    double rMax2 = maxRadii[end][current];
-    double rMin2 = minRadii[end][current];
+template <class T, int D>
+void QuIKT<T, D>::ResolveJoint(int jointIndex) {
+    if (!workspace.lazyPending) return;
 
-    if (d1 <= rMax1 && d1 >= rMin1 &&
-        d2 <= rMax2 && d2 >= rMin2) {
+    (this->*resolvePath)(positions.EditView(), jointIndex);
+
+    // Done once the whole chain is placed
+    if (workspace.lazyIntervals[0] == workspace.numLazySolutions) {
+        workspace.lazyPending = false;
+    }
+}
+
+template <class T, int D>
+void QuIKT<T, D>::ResolveJoints() {
+    ResolveJoint(-1);
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::ResolvePath(Vec* joints, int jointIndex) {
+    // The plan is one interval, the whole chain
+    if (jointIndex == -1) {
+        ResolveInterval<Placement>(joints, 0);
+
+        return;
+    }
+
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+    unsigned long long solution = workspace.numLazySolutions;
+
+    // Work down from the whole chain to the joint, making each placement on the way.  The 
+    // halves of an interval only share its current joint, so the second half can be placed 
+    // before the first unless either moves that joint, when it waits for all of the first.
+    int i = 0;
+    while (workspace.lazyIntervals[i] != solution) {
+        const SolvePlan::Placement& p = placements[i];
+
+        ResolvePlacement<Placement>(joints, i);
+
+        if (p.size == 1) {
+            workspace.lazyIntervals[i] = solution;
+
+            return;
+        }
+
+        int firstHalf = i + 1;
+        int secondHalf = firstHalf + placements[firstHalf].size;
+
+        if (jointIndex < p.current) {
+            i = firstHalf;
+
+            continue;
+        }
+
+        if (placements[firstHalf].writesEnd || placements[secondHalf].writesStart) {
+            ResolveInterval<Placement>(joints, firstHalf);
+        }
+
+        if (jointIndex > p.current) {
+            i = secondHalf;
+
+            continue;
+        }
+
+        // The current joint itself, which the second half can also move
+        if (placements[secondHalf].writesStart) {
+            ResolveInterval<Placement>(joints, secondHalf);
+        }
+
+        return;
+    }
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::ResolveInterval(Vec* joints, int first) {
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+    unsigned long long solution = workspace.numLazySolutions;
+
+    // The remaining placements in the order of the plan, skipping intervals already placed
+    int last = first + placements[first].size;
+    for (int i = first; i < last;) {
+        if (workspace.lazyIntervals[i] == solution) {
+            i += placements[i].size;
+
+            continue;
+        }
+
+        ResolvePlacement<Placement>(joints, i);
+
+        // The rest of the interval is placed by this loop
+        workspace.lazyIntervals[i] = solution;
+        i++;
+    }
+}
+
+template <class T, int D>
+template <class Placement>
+void QuIKT<T, D>::ResolvePlacement(Vec* joints, int i) {
+    if (workspace.lazyPlaced[i] == workspace.numLazySolutions) return;
+
+    const SolvePlan::Placement& p = plan.GetPlacement(i);
+
+    joints[p.current] = Placement::Place(joints, reach, p.start, p.current, p.end);
+
+    workspace.lazyPlaced[i] = workspace.numLazySolutions;
+    workspace.numPlaced++;
+    workspace.numSkipped--;
+}
+
+template <class T, int D>
+VecT<T, D> QuIKT<T, D>::PlaceJointTriangulation(const Vec& p, const Vec& c1, const Vec& c2, T rMax1, T rMax2) {
+    // Perform sphere-sphere intersection
+    typename Sphere::SSI_Type i;
+    Vec c;
+    T r;
+    Vec n;
+    Sphere::Intersection(c1, c2, 1, &rMax1, &rMax2, &i, &c, &r, &n);
+
+    // Set the position based on the sphere-sphere intersection
+    return HandleSphereSphereIntersection(p, i, c, r, n);
+}
+
+template <class T, int D>
+VecT<T, D> QuIKT<T, D>::PlaceJointInertial(const Vec& p, const Vec& c1, const Vec& c2, T rMax1, T rMin1, T rMax2, T rMin2) {
+    SphereShell shells[2] = { SphereShell(c1, rMin1, rMax1), SphereShell(c2, rMin2, rMax2) };
+
+    if (shells[0].IsValid(p) && shells[1].IsValid(p)) {
         // Already in a good spot, leave it alone
+        return p;
     }
     else {
         // Find closest legitimate point
-        SphereInterior sMax1(c1, rMax1);
-        SphereExterior sMin1(c1, rMin1);
-        SphereInterior sMax2(c2, rMax2);
-        SphereExterior sMin2(c2, rMin2);
-
-        Vec3 points[4];
-        points[0] = sMax1.ClosestPoint(p);
-        points[1] = sMin1.ClosestPoint(p);
-        points[2] = sMax2.ClosestPoint(p);
-        points[3] = sMin2.ClosestPoint(p);
-
-        double closestDistance;
-        int closest = -1;
-        double epsilon = 1e-10;
-        for (int i = 0; i < 4; i++) {
-            if ((points[i].Distance(c1) <= rMax1 + epsilon) &&
-                (points[i].Distance(c1) >= rMin1 - epsilon) &&
-                (points[i].Distance(c2) <= rMax2 + epsilon) &&
-                (points[i].Distance(c2) >= rMin2 - epsilon)) {
-                // Compute the distance
-                double d = p.Distance(points[i]);
-
-                // Check if closest
-                if (closest == -1) {
-                    closestDistance = d;
-                    closest = i;
-                }
-                else if (d < closestDistance) {
-                    closestDistance = d;
-                    closest = i;
-                }
-            }
-        }
+        Vec points[2];
+        points[0] = shells[0].ClosestPoint(p);
+        points[1] = shells[1].ClosestPoint(p);
+
+        int closest = ClosestValidPoint(p, points, 2, shells, 2);
 
         if (closest != -1) {
             // At least one of the points worked, use the closest
-            positions[current] = points[closest];  
+            return points[closest];  
         }
         else {       
-            // Four spheres
-            Sphere s1Max(positions[start], maxRadii[start][current]);
-            Sphere s1Min(positions[start], minRadii[start][current]);
-            Sphere s2Max(positions[end], maxRadii[end][current]);
-            Sphere s2Min(positions[end], minRadii[end][current]);
-
-            // Compute intersections
-            Sphere::SSI_Type iType[4];
-            Vec3 c[4];
-            double r[4];
-            Vec3 n[4];
-
-            iType[0] = s1Max.Intersection(s2Max, c[0], r[0], n[0]);
-            iType[1] = s1Max.Intersection(s2Min, c[1], r[1], n[1]);
-            iType[2] = s2Max.Intersection(s1Min, c[2], r[2], n[2]);
-            iType[3] = s1Min.Intersection(s2Min, c[3], r[3], n[3]);
+            // Distance and direction between the centers, shared by the shell boundaries
+            Vec n12 = c2 - c1;
+            T d = n12.Magnitude();
+            n12.Normalize();
+
+            // Compute intersections.  The third intersects from the end joint, with the 
+            // direction reversed.
+            typename Sphere::SSI_Type iType[4];
+            Vec c[4];
+            T r[4];
+            Vec n[4];
+
+            iType[0] = Sphere::Intersection(c1, rMax1, c2, rMax2, d, n12, c[0], r[0], n[0]);
+            iType[1] = Sphere::Intersection(c1, rMax1, c2, rMin2, d, n12, c[1], r[1], n[1]);
+            iType[2] = Sphere::Intersection(c2, rMax2, c1, rMin1, d, !n12, c[2], r[2], n[2]);
+            iType[3] = Sphere::Intersection(c1, rMin1, c2, rMin2, d, n12, c[3], r[3], n[3]);
 
             // Handle the intersections
-            Vec3 points[4];
+            Vec points[4];
             for (int i = 0; i < 4; i++) {
-                points[i] = HandleSphereSphereIntersection(positions[current], iType[i], c[i], r[i], n[i]);
+                points[i] = HandleSphereSphereIntersection(p, iType[i], c[i], r[i], n[i]);
             }
 
+            // The centers are only within the tolerance of each other's shells, so an 
+            // intersection can miss a shell by the tolerance plus rounding.  Accept the 
+            // intersection points within twice the tolerance.
+            T epsilon = ScalarTraits<T>::Epsilon();
+            SphereShell widened[2] = { SphereShell(c1, rMin1 - epsilon, rMax1 + epsilon), 
+                                       SphereShell(c2, rMin2 - epsilon, rMax2 + epsilon) };
+
             // Choose the closest intersection point
-            double closestDistance;
-            int closest = -1;
-            double epsilon = 1e-10;
-            for (int i = 0; i < 4; i++) {
-                if ((points[i].Distance(c1) <= rMax1 + epsilon) &&
-                    (points[i].Distance(c1) >= rMin1 - epsilon) &&
-                    (points[i].Distance(c2) <= rMax2 + epsilon) &&
-                    (points[i].Distance(c2) >= rMin2 - epsilon)) {
-                    // Compute the distance
-                    double d = p.Distance(points[i]);
-
-                    // Check if closest
-                    if (closest == -1) {
-                        closestDistance = d;
-                        closest = i;
-                    }
-                    else if (d < closestDistance) {
-                        closestDistance = d;
-                        closest = i;
-                    }
-                }
-            }
+            int closest = ClosestValidPoint(p, points, 4, widened, 2);
 
             
-            // Set the position
-            positions[current] = points[closest];
+            // Set the position, or leave it where it is if none of the points worked
+            if (closest == -1) {
+                return p;
+            }
+
+            return points[closest];
         }
     }
 }
 
 
-Vec3 QuIK::HandleSphereSphereIntersection(const Vec3& p, Sphere::SSI_Type i, const Vec3& c, double r, const Vec3& n) {
+// The two points to choose between on a circle of intersection.  In 2D they are the whole 
+// intersection.  In 3D they are taken perpendicular to n in the xy plane.
+template <class T>
+static void CirclePoints(const Vec2T<T>& c, T r, const Vec2T<T>& n, Vec2T<T>& p1, Vec2T<T>& p2) {
+    p1 = c + Vec2T<T>(-n.y(), n.x()) * r;
+    p2 = c + Vec2T<T>(n.y(), -n.x()) * r;
+}
+
+template <class T>
+static void CirclePoints(const Vec3T<T>& c, T r, const Vec3T<T>& n, Vec3T<T>& p1, Vec3T<T>& p2) {
+    p1 = c + Vec3T<T>(-n.y(), n.x(), n.z()) * r;
+    p2 = c + Vec3T<T>(n.y(), -n.x(), n.z()) * r;
+}
+
+template <class T, int D>
+VecT<T, D> QuIKT<T, D>::HandleSphereSphereIntersection(const Vec& p, typename Sphere::SSI_Type i, const Vec& c, T r, const Vec& n) {
     switch (i) {
 
         case Sphere::SSI_EmptyOutside:
@@ -592,9 +1233,11 @@ Vec3 QuIK::HandleSphereSphereIntersection(const Vec3& p, Sphere::SSI_Type i, con
         case Sphere::SSI_Circle: {
 
             // Pick the closest of the two possible points
-            Vec3 p1 = c + Vec3(-n.y(), n.x(), n.z()) * r;
-            Vec3 p2 = c + Vec3(n.y(), -n.x(), n.z()) * r;
-            if (p.Distance(p1) < p.Distance(p2)) {
+            Vec p1;
+            Vec p2;
+            CirclePoints(c, r, n, p1, p2);
+
+            if (p.DistanceSquared(p1) < p.DistanceSquared(p2)) {
                 return p1;
             }
             else {
@@ -605,7 +1248,7 @@ Vec3 QuIK::HandleSphereSphereIntersection(const Vec3& p, Sphere::SSI_Type i, con
         case Sphere::SSI_Sphere: {
 
             // Pick the closest point on the sphere
-            SphereInterior s(c, r);
+            SphereInteriorT<T, D> s(c, r);
 
             return s.ClosestPoint(p);
         }
@@ -617,7 +1260,159 @@ Vec3 QuIK::HandleSphereSphereIntersection(const Vec3& p, Sphere::SSI_Type i, con
     }
 }
 
-int QuIK::ClosestValidPoint(const Vec3& p1, const std::vector<Vec3> p2, const std::vector<Sphere*> s) {
-    // XXX: STUB!
-    return -1;
-}
\ No newline at end of file
+template <class T, int D>
+int QuIKT<T, D>::ClosestValidPoint(const Vec& p, const Vec* points, int numPoints, const SphereShell* shells, int numShells) {
+    // Test the candidates in blocks of two, as the SSE2 version for doubles does.  Within a 
+    // block every candidate is tested against every shell without branching, and only the 
+    // final choice branches.
+    const int blockSize = 2;
+
+    T closestDistance = T(0);
+    int closest = -1;
+    for (int first = 0; first < numPoints; first += blockSize) {
+        int n = std::min(blockSize, numPoints - first);
+
+        // Copy the block by component, repeating the last candidate to fill it
+        T q[D][blockSize];
+        for (int i = 0; i < blockSize; i++) {
+            const Vec& point = points[first + std::min(i, n - 1)];
+
+            for (int d = 0; d < D; d++) {
+                q[d][i] = point[d];
+            }
+        }
+
+        // Squared distances, summing the components in order as the vector classes do
+        T distance[blockSize];
+        int valid[blockSize];
+        for (int i = 0; i < blockSize; i++) {
+            T delta = p[0] - q[0][i];
+            distance[i] = delta * delta;
+
+            for (int d = 1; d < D; d++) {
+                delta = p[d] - q[d][i];
+                distance[i] += delta * delta;
+            }
+
+            valid[i] = 1;
+        }
+
+        for (int s = 0; s < numShells; s++) {
+            Vec c = shells[s].c();
+
+            T minSquared;
+            T maxSquared;
+            shells[s].ValidRange(minSquared, maxSquared);
+
+            for (int i = 0; i < blockSize; i++) {
+                T delta = c[0] - q[0][i];
+                T d2 = delta * delta;
+
+                for (int d = 1; d < D; d++) {
+                    delta = c[d] - q[d][i];
+                    d2 += delta * delta;
+                }
+
+                valid[i] &= (d2 >= minSquared) & (d2 <= maxSquared);
+            }
+        }
+
+        // Keep the first of equally close candidates
+        for (int i = 0; i < n; i++) {
+            if (valid[i] && (closest == -1 || distance[i] < closestDistance)) {
+                closestDistance = distance[i];
+                closest = first + i;
+            }
+        }
+    }
+
+    return closest;
+}
+
+#ifdef QUIK_HAVE_SSE2
+// Two candidates at a time, one in each lane of an SSE2 register, with the same arithmetic 
+// in the same order as the general version
+template <>
+int QuIKT<double, 3>::ClosestValidPoint(const Vec& p, const Vec* points, int numPoints, const SphereShell* shells, int numShells) {
+    const __m128d px = _mm_set1_pd(p[0]);
+    const __m128d py = _mm_set1_pd(p[1]);
+    const __m128d pz = _mm_set1_pd(p[2]);
+    const __m128d all = _mm_castsi128_pd(_mm_set1_epi32(-1));
+
+    double closestDistance = 0.0;
+    int closest = -1;
+    for (int first = 0; first < numPoints; first += 2) {
+        // Repeat the last candidate to fill the register
+        const Vec& q0 = points[first];
+        const Vec& q1 = points[std::min(first + 1, numPoints - 1)];
+
+        __m128d qx = _mm_set_pd(q1[0], q0[0]);
+        __m128d qy = _mm_set_pd(q1[1], q0[1]);
+        __m128d qz = _mm_set_pd(q1[2], q0[2]);
+
+        __m128d dx = _mm_sub_pd(px, qx);
+        __m128d dy = _mm_sub_pd(py, qy);
+        __m128d dz = _mm_sub_pd(pz, qz);
+        __m128d distance = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+
+        __m128d valid = all;
+        for (int s = 0; s < numShells; s++) {
+            Vec c = shells[s].c();
+
+            double minSquared;
+            double maxSquared;
+            shells[s].ValidRange(minSquared, maxSquared);
+
+            dx = _mm_sub_pd(_mm_set1_pd(c[0]), qx);
+            dy = _mm_sub_pd(_mm_set1_pd(c[1]), qy);
+            dz = _mm_sub_pd(_mm_set1_pd(c[2]), qz);
+            __m128d d2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+
+            valid = _mm_and_pd(valid, _mm_and_pd(_mm_cmpge_pd(d2, _mm_set1_pd(minSquared)), 
+                                                 _mm_cmple_pd(d2, _mm_set1_pd(maxSquared))));
+        }
+
+        int validMask = _mm_movemask_pd(valid);
+        double distances[2];
+        _mm_storeu_pd(distances, distance);
+
+        // Keep the first of equally close candidates
+        int n = std::min(2, numPoints - first);
+        for (int i = 0; i < n; i++) {
+            if ((validMask >> i & 1) && (closest == -1 || distances[i] < closestDistance)) {
+                closestDistance = distances[i];
+                closest = first + i;
+            }
+        }
+    }
+
+    return closest;
+}
+#endif
+
+
+template class QuIKT<float, 2>;
+template class QuIKT<double, 2>;
+template class QuIKT<Fixed, 2>;
+template class QuIKT<float, 3>;
+template class QuIKT<double, 3>;
+template class QuIKT<Fixed, 3>;
+
+
+// The solvers for each combination of policies
+#define INSTANTIATE_SOLVEIKWITH(T, D) \
+    template void QuIKT<T, D>::SolveIKWith<JointPolicies::IncreasingJointOrder, JointPolicies::TriangulationJointPlacement>(); \
+    template void QuIKT<T, D>::SolveIKWith<JointPolicies::IncreasingJointOrder, JointPolicies::InertialJointPlacement>(); \
+    template void QuIKT<T, D>::SolveIKWith<JointPolicies::DecreasingJointOrder, JointPolicies::TriangulationJointPlacement>(); \
+    template void QuIKT<T, D>::SolveIKWith<JointPolicies::DecreasingJointOrder, JointPolicies::InertialJointPlacement>(); \
+    template void QuIKT<T, D>::SolveIKWith<JointPolicies::DividingJointOrder, JointPolicies::TriangulationJointPlacement>(); \
+    template void QuIKT<T, D>::SolveIKWith<JointPolicies::DividingJointOrder, JointPolicies::InertialJointPlacement>();
+
+INSTANTIATE_SOLVEIKWITH(float, 2)
+INSTANTIATE_SOLVEIKWITH(double, 2)
+INSTANTIATE_SOLVEIKWITH(Fixed, 2)
+INSTANTIATE_SOLVEIKWITH(float, 3)
+INSTANTIATE_SOLVEIKWITH(double, 3)
+INSTANTIATE_SOLVEIKWITH(Fixed, 3)
+
+#undef INSTANTIATE_SOLVEIKWITH
\ No newline at end of file
@@ -4,40 +4,106 @@
 
   Author:      David Borland
 
-  Description: Class to implement quantum inverse kinematics.
+  Description: Class to implement quantum inverse kinematics.  Templated on 
+               the scalar type and the dimension, with QuIK the 3D double 
+               version and QuIK2D the planar double version.
 
 =========================================================================*/
 
 
-#include "Vec3.h"
+#ifndef QUIK_H
+#define QUIK_H
+
+
+#include "VecN.h"
 #include "Sphere.h"
+#include "SphereShell.h"
+#include "ChainReach.h"
+#include "JointPositions.h"
+#include "SolvePlan.h"
+#include "SolveWorkspace.h"
+#include "ThreadPool.h"
 
 #include <vector>
 
 
-class QuIK {
+template <class T, int D = 3>
+class QuIKT {
 public:
+    typedef VecT<T, D> Vec;
+    typedef SphereT<T, D> Sphere;
+    typedef SphereShellT<T, D> SphereShell;
+    typedef ChainReachT<T> ChainReach;
+    typedef JointPositionsT<T, D> JointPositions;
+    typedef SolveWorkspaceT<T, D> SolveWorkspace;
+
     // Constructor
-    QuIK();
+    QuIKT();
 
     // Set bones or joints
-    void SetBones(const std::vector<double>& boneLengths);
-    void SetJoints(const std::vector<Vec3>& jointPositions);
+    void SetBones(const std::vector<T>& boneLengths);
+    void SetJoints(const std::vector<Vec>& jointPositions);
 
     // Manipulate joints
-    void AddJoint(int jointIndex, Vec3 position);
+    void AddJoint(int jointIndex, Vec position);
     void DeleteJoint(int jointIndex);
-    void SetJointPosition(int jointIndex, Vec3 position);
+    void SetJointPosition(int jointIndex, Vec position);
 
     // Get/set target and target joint
     int GetTargetJoint();
     void SetTargetJoint(int targetJointIndex);
-    const Vec3& GetTarget();
-    void SetTarget(const Vec3& targetPosition);
+    const Vec& GetTarget();
+    void SetTarget(const Vec& targetPosition);
 
     // Solve
     void SolveIK();
 
+    // Solve with the joint order and placement policy types from JointPolicies.h, setting 
+    // the joint order and placement types to match.  Instantiated for each policy.
+    template <class Order, class Placement>
+    void SolveIKWith();
+
+    // Solve for each target, starting from the current joint positions each time, without 
+    // changing them.  Writes GetNumJoints() positions per target to poses, in target order.
+    void SolveIK(const Vec* targets, int numTargets, Vec* poses);
+    void SolveIK(const std::vector<Vec>& targets, std::vector<Vec>& poses);
+
+    // Execution.  Parallel execution solves the two halves of each interval at the same 
+    // time when using DividingJointOrder, and is the same as serial execution otherwise.
+    enum ExecutionType {
+        SerialExecution,
+        ParallelExecution
+    };
+    ExecutionType GetExecutionType();
+    void SetExecutionType(ExecutionType type);
+
+    // Intervals with fewer joint placements than the grain size are solved serially
+    int GetGrainSize();
+    void SetGrainSize(int size);
+
+    // Thread pool for split solves and parallel execution.  Uses the global pool if NULL, the default.
+    void SetThreadPool(ThreadPool* pool);
+
+    // Update type.  Incremental update skips the intervals whose joints have not moved since 
+    // they were last solved, if nothing moved then, for a target that moves a little at a 
+    // time.  Gives the same result as a full update.  Single pass serial solves only, and 
+    // the same as a full update otherwise.
+    //
+    // Lazy update only places the target joint when solving, and places the other joints 
+    // serially when they are requested, making just the placements each one depends on.  
+    // The requested joints are the same as a full update from the positions that solve 
+    // started from.  Joints not requested before the next solve keep their earlier 
+    // positions, and the next solve starts from them, so a sequence of lazy solves gives 
+    // the same joints as a sequence of full updates only if GetPositions() is called after 
+    // each solve.
+    enum UpdateType {
+        FullUpdate,
+        IncrementalUpdate,
+        LazyUpdate
+    };
+    UpdateType GetUpdateType();
+    void SetUpdateType(UpdateType type);
+
     // Joint order
     enum JointOrderType {
         IncreasingJointOrder,
@@ -47,7 +113,19 @@ public:
     JointOrderType GetJointOrderType();
     void SetJointOrderType(JointOrderType type);
 
-    // Joint placement
+    // Solve type.  Split solve places the target joint first, then solves each side of it 
+    // at the same time.
+    enum SolveType {
+        SinglePassSolve,
+        SplitSolve
+    };
+    SolveType GetSolveType();
+    void SetSolveType(SolveType type);
+
+    // Joint placement.  Inertial placement moves each joint to the closer of two candidate 
+    // positions.  When both are nearly equally close, rounding decides, so solves with 
+    // different scalar types can place the joint on different sides.  The bone lengths and 
+    // the end effector still agree to within rounding.
     enum JointPlacementType {
         TriangulationJointPlacement,
         InertialJointPlacement
@@ -65,58 +143,162 @@ public:
     int GetNumJoints();
 
     // Get bone lengths and joint positions
-    const std::vector<double>& GetLengths();
-    const std::vector<Vec3>& GetPositions();
+    const std::vector<T>& GetLengths();
+    const std::vector<Vec>& GetPositions();
+    Vec GetPosition(int jointIndex);
 
     // Get joint priorities
     const std::vector<int>& GetPriorities();
 
-    // Get radii data structures
-    const std::vector<std::vector<double>>& GetMaxRadii();
-    const std::vector<std::vector<double>>& GetMinRadii();
+    // Get reach data structure
+    const ChainReach& GetReach();
+    T GetMaxRadius(int i, int j);
+    T GetMinRadius(int i, int j);
+
+    // Get radii tables, created on first request.  O(n^2), prefer GetReach()
+    const std::vector<std::vector<T>>& GetMaxRadii();
+    const std::vector<std::vector<T>>& GetMinRadii();
 
-    // Get order of joint placement during most recent solution
+    // Recording of the order of joint placement
+    enum TraceLevel {
+        NoTrace,
+        JointOrderTrace
+    };
+    TraceLevel GetTraceLevel();
+    void SetTraceLevel(TraceLevel level);
+
+    // Get order of joint placement during most recent solution.  Empty with NoTrace.
     const std::vector<int>& GetStartOrder();
     const std::vector<int>& GetCurrentOrder();
     const std::vector<int>& GetEndOrder();
 
+    // Get the number of joint placements made and skipped during the most recent solution
+    int GetNumPlacementsMade();
+    int GetNumPlacementsSkipped();
+
+    // Get the order of joint placement, compiling it if necessary
+    const SolvePlan& GetPlan();
+
+    // Joint placement from the positions and reach of the joints around the one being 
+    // placed, for solvers that keep the chain and radii themselves
+    static Vec PlaceLastJoint(const Vec& first, const Vec& last, const Vec& targetPosition, T maxRadius, T minRadius);
+    static Vec PlaceJointTriangulation(const Vec& p, const Vec& c1, const Vec& c2, T rMax1, T rMax2);
+    static Vec PlaceJointInertial(const Vec& p, const Vec& c1, const Vec& c2, T rMax1, T rMin1, T rMax2, T rMin2);
+
 protected:
     // Create the radii data structures
     void CreateRadii();
+    void CreateRadiiTables();
+
+    // Compile the order of joint placement, choosing the joint order policy once
+    void CompilePlan();
+    template <class Order>
+    void CompilePlan();
+    template <class Order>
+    void CompilePlan(int start, int end);
+    template <class Order>
+    int PickJoint(int start, int end);
+
+    // Solve for the target, choosing the joint placement policy once for the joint order 
+    // policy, then with both policies.  SolveIK() and SolveIKWith() share these.
+    template <class Order>
+    void SolveTarget();
+    template <class Order, class Placement>
+    void SolveTarget();
+
+    // Solve with the plan, once the target joint is placed
+    template <class Placement>
+    void Solve(Vec* joints);
+
+    // Solve in parallel
+    template <class Placement>
+    void SolveParallel();
+    template <class Placement>
+    void SolveParallel(ThreadPool& pool, int first, int deferred);
+    template <class Placement>
+    static void SolveParallelTask(void* data, int first);
+
+    // Solve for targets in parallel
+    struct TargetTasks {
+        QuIKT* ik;
+        const Vec* targets;
+        int numTargets;
+        int targetsPerTask;
+        Vec* poses;
+    };
+    template <class Placement>
+    static void SolveTargetsTask(void* data, int task);
+
+    // Place the target joint, then all joints in the order of the plan, in the given joints
+    void PlaceTargetJoint(Vec* joints, const Vec& targetPosition);
+    template <class Placement>
+    void PlaceJoints(Vec* joints);
+
+    // Place the joints in the order of the plan, skipping settled intervals
+    template <class Placement>
+    void UpdateJoints(Vec* joints);
 
-    // Solve the IK
-    void SolveIK(int start, int end);
-    void PlaceJointTriangulation(int start, int current, int end);
-    void PlaceJointInertial(int start, int current, int end);
+    // Make the placements of a lazy solution that a joint depends on, or all of them
+    void ResolveJoint(int jointIndex);
+    void ResolveJoints();
+
+    typedef void (QuIKT::*ResolveFunction)(Vec* joints, int jointIndex);
+    template <class Placement>
+    void ResolvePath(Vec* joints, int jointIndex);  // All placements if jointIndex is -1
+    template <class Placement>
+    void ResolveInterval(Vec* joints, int first);
+    template <class Placement>
+    void ResolvePlacement(Vec* joints, int i);
 
     // Handle result of sphere-sphere intersection
-    Vec3 HandleSphereSphereIntersection(const Vec3& p, Sphere::SSI_Type i, const Vec3& c, double r, const Vec3& n);
+    static Vec HandleSphereSphereIntersection(const Vec& p, typename Sphere::SSI_Type i, const Vec& c, T r, const Vec& n);
 
-    // Find the closest point in p2 to the given point p1 that is valid for the given spheres
-    int ClosestValidPoint(const Vec3& p1, const std::vector<Vec3> p2, const std::vector<Sphere*> s);
+    // Index of the point in points closest to p that is in all of the shells, or -1 if none are
+    static int ClosestValidPoint(const Vec& p, const Vec* points, int numPoints, const SphereShell* shells, int numShells);
 
 
     // Bone chain
-    std::vector<double> lengths;
-    std::vector<Vec3> positions;
+    std::vector<T> lengths;
+    JointPositions positions;
     
     std::vector<int> priorities;
-    std::vector<int> tempPriorities;
     
     // Radius data structures
-    std::vector<std::vector<double>> maxRadii;
-    std::vector<std::vector<double>> minRadii;
+    ChainReach reach;
+
+    std::vector<std::vector<T>> maxRadii;
+    std::vector<std::vector<T>> minRadii;
+    bool radiiTablesValid;
 
     // Target Position
     int targetJoint;
-    Vec3 target;
+    Vec target;
 
     // Algorithm parameters
     JointOrderType jointOrderType;
     JointPlacementType jointPlacementType;
+    TraceLevel traceLevel;
+
+    SolveType solveType;
+    ExecutionType executionType;
+    UpdateType updateType;
+    int grainSize;
+    ThreadPool* threadPool;
+
+    // Order of joint placement
+    SolvePlan plan;
+
+    // Placement of the joints of the most recent lazy solution
+    ResolveFunction resolvePath;
+
+    // Scratch space for compiling the plan, including the description of the most recent 
+    // IK solution
+    SolveWorkspace workspace;
+};
+
+
+typedef QuIKT<double> QuIK;
+typedef QuIKT<double, 2> QuIK2D;
+
 
-    // Description of most recent IK solution
-    std::vector<int> startOrder;
-    std::vector<int> currentOrder;
-    std::vector<int> endOrder;
-};
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        QuIKBatch.cpp
+//
+// Author:      David Borland
+//
+// Description: Solves the IK for many chains at once on a thread pool.  The chains are 
+//              split into contiguous chunks with roughly the same number of joints, and 
+//              each chunk is solved as a task.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#include "QuIKBatch.h"
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+QuIKBatch::QuIKBatch() {
+    chains = NULL;
+    targets = NULL;
+
+    grainSize = 4096;
+    threadPool = NULL;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Solve
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void QuIKBatch::SolveIK(QuIK* const* batchChains, const Vec3* batchTargets, int numChains) {
+    if (numChains <= 0) return;
+
+    ThreadPool& pool = threadPool ? *threadPool : ThreadPool::GetGlobal();
+
+    // Estimate the cost of each chain by its number of joints
+    long long totalCost = 0;
+    for (int i = 0; i < numChains; i++) {
+        totalCost += batchChains[i]->GetNumJoints();
+    }
+
+    // Aim for a few chunks per thread, so threads that finish early can steal the rest
+    int maxChunks = 4 * (pool.GetNumThreads() + 1);
+    long long chunkCost = (totalCost + maxChunks - 1) / maxChunks;
+    if (chunkCost < grainSize) chunkCost = grainSize;
+
+    // Split into contiguous chunks
+    chunkStarts.clear();
+    long long cost = 0;
+    for (int i = 0; i < numChains; i++) {
+        if (cost == 0) chunkStarts.push_back(i);
+
+        cost += batchChains[i]->GetNumJoints();
+
+        if (cost >= chunkCost) cost = 0;
+    }
+    chunkStarts.push_back(numChains);
+
+    chains = batchChains;
+    targets = batchTargets;
+
+    int numChunks = chunkStarts.size() - 1;
+
+    if (numChunks == 1) {
+        SolveChunk(this, 0);
+    }
+    else {
+        ThreadPool::TaskGroup group;
+
+        for (int i = 0; i < numChunks; i++) {
+            pool.Run(group, SolveChunk, this, i);
+        }
+
+        pool.Wait(group);
+    }
+
+    chains = NULL;
+    targets = NULL;
+}
+
+void QuIKBatch::SolveIK(const std::vector<QuIK*>& batchChains, const std::vector<Vec3>& batchTargets) {
+    int numChains = batchChains.size() < batchTargets.size() ? batchChains.size() : batchTargets.size();
+
+    if (numChains == 0) return;
+
+    SolveIK(&batchChains[0], &batchTargets[0], numChains);
+}
+
+void QuIKBatch::SolveChunk(void* data, int chunk) {
+    QuIKBatch* batch = (QuIKBatch*)data;
+
+    for (int i = batch->chunkStarts[chunk]; i < batch->chunkStarts[chunk + 1]; i++) {
+        batch->chains[i]->SetTarget(batch->targets[i]);
+        batch->chains[i]->SolveIK();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Parameters
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+int QuIKBatch::GetGrainSize() {
+    return grainSize;
+}
+
+void QuIKBatch::SetGrainSize(int size) {
+    grainSize = size;
+}
+
+void QuIKBatch::SetThreadPool(ThreadPool* pool) {
+    threadPool = pool;
+}
\ No newline at end of file
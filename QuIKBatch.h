@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        QuIKBatch.h
+//
+// Author:      David Borland
+//
+// Description: Solves the IK for many chains at once on a thread pool.  The chains are 
+//              split into contiguous chunks with roughly the same number of joints, and 
+//              each chunk is solved as a task.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#ifndef QUIKBATCH_H
+#define QUIKBATCH_H
+
+
+#include "QuIK.h"
+#include "ThreadPool.h"
+#include "Vec3.h"
+
+#include <vector>
+
+
+class QuIKBatch {
+public:
+    // Constructor
+    QuIKBatch();
+
+    // Use default destructor
+
+
+    // Set the target of each chain and solve it.  Each chain is solved exactly as by its own 
+    // SolveIK(), so the results do not depend on the number of threads.  Each chain can only 
+    // be given once.
+    void SolveIK(QuIK* const* chains, const Vec3* targets, int numChains);
+    void SolveIK(const std::vector<QuIK*>& chains, const std::vector<Vec3>& targets);
+
+    // Chunks have at least this many joints, unless there are not enough chains
+    int GetGrainSize();
+    void SetGrainSize(int size);
+
+    // Thread pool for the chunks.  Uses the global pool if NULL, the default.
+    void SetThreadPool(ThreadPool* pool);
+
+protected:
+    // Use no copy constructor or assignment operator
+    QuIKBatch(const QuIKBatch&);
+    QuIKBatch& operator=(const QuIKBatch&);
+
+
+    // Solve the chains in a chunk
+    static void SolveChunk(void* data, int chunk);
+
+
+    // Chains being solved
+    QuIK* const* chains;
+    const Vec3* targets;
+
+    // First chain of each chunk, followed by the number of chains
+    std::vector<int> chunkStarts;
+
+    int grainSize;
+    ThreadPool* threadPool;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        Allocations.cpp
+//
+// Author:      David Borland
+//
+// Description: Counts the heap allocations made by the whole program, by replacing every 
+//              form of new and delete.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Allocations.h"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+
+// Every new allocates with malloc and every delete frees with free.  They are kept in their 
+// own file, so a delete is never inlined next to a new it cannot see.  The count is atomic, 
+// as pool threads allocate too.
+static std::atomic<long> numAllocations(0);
+
+static void* Allocate(size_t size) {
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    return malloc(size > 0 ? size : 1);
+}
+
+static void Deallocate(void* p) {
+    free(p);
+}
+
+
+long GetNumAllocations() {
+    return numAllocations.load(std::memory_order_relaxed);
+}
+
+
+void* operator new(size_t size) {
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = Allocate(size);
+    if (!p) throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    Deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    Deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    Deallocate(p);
+}
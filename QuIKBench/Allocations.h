@@ -0,0 +1,21 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        Allocations.h
+//
+// Author:      David Borland
+//
+// Description: Counts the heap allocations made by the whole program, by replacing every 
+//              form of new and delete.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+
+// Number of allocations since the program started
+long GetNumAllocations();
+
+
+#endif
@@ -0,0 +1,1675 @@
+/*=========================================================================
+
+  Name:        QuIKBench.cpp
+
+  Author:      David Borland
+
+  Description: Timing benchmarks for the QuIK solver.  Run with the name 
+               of a benchmark to run just that one, or with no arguments 
+               to run them all.  Checks, such as alloc and reach, make 
+               the run exit with an error if they fail.
+
+=========================================================================*/
+
+
+#include "Allocations.h"
+
+#include "QuIK.h"
+#include "QuIKBatch.h"
+#include "QuIKLanes.h"
+#include "Fixed.h"
+#include "Sphere.h"
+#include "SphereConstraint.h"
+#include "StaticQuIK.h"
+
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Seconds since an arbitrary point
+static double Seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A point in the xy plane
+template <class T, int D>
+static VecT<T, D> PlanePoint(double x, double y) {
+    VecT<T, D> p;
+    p[0] = T(x);
+    p[1] = T(y);
+
+    return p;
+}
+
+// Create a zig-zag chain in the xy plane
+template <class T, int D>
+static void CreateChain(QuIKT<T, D>& ik, int numJoints) {
+    std::vector<VecT<T, D> > joints(numJoints);
+    for (int i = 1; i < numJoints; i++) {
+        joints[i] = joints[i - 1] + PlanePoint<T, D>(1.0, i % 2 == 0 ? 0.5 : -0.5);
+    }
+
+    ik.SetJoints(joints);
+}
+
+// Solve for a target that moves around a circle, returning nanoseconds per joint placement
+template <class T, int D>
+static double TimeSolve(QuIKT<T, D>& ik, int numSolves) {
+    double radius = ik.GetNumBones() * 0.75;
+
+    double start = Seconds();
+    int numPlacements = 0;
+    for (int i = 0; i < numSolves; i++) {
+        double angle = i * 0.1;
+        ik.SetTarget(PlanePoint<T, D>(radius * cos(angle), radius * sin(angle)));
+        ik.SolveIK();
+
+        numPlacements += ik.GetPlan().GetNumPlacements();
+    }
+    double elapsed = Seconds() - start;
+
+    return elapsed * 1e9 / numPlacements;
+}
+
+
+// Number of joints that are not bitwise the same in two solves
+static int NumDifferent(const std::vector<Vec3>& a, const std::vector<Vec3>& b) {
+    if (a.size() != b.size()) return (int)std::max(a.size(), b.size());
+
+    int numDifferent = 0;
+    for (int i = 0; i < (int)a.size(); i++) {
+        if (!(a[i] == b[i])) numDifferent++;
+    }
+
+    return numDifferent;
+}
+
+// Print the number of differences for one case of a check, returning whether there were none
+static bool ReportDifferences(const std::string& name, int numDifferent) {
+    std::cout << "  " << name << ": " << numDifferent 
+              << (numDifferent > 0 ? "  FAILED" : "") << std::endl;
+
+    return numDifferent == 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Per-placement cost of a full solve for each joint order and chain length
+static void SolveBenchmark() {
+    std::cout << "solve: nanoseconds per joint placement" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    int numJoints[] = { 4, 8, 64, 1024, 16384 };
+
+    for (int order = 0; order < 3; order++) {
+        for (int i = 0; i < 5; i++) {
+            QuIK ik;
+            CreateChain(ik, numJoints[i]);
+            ik.SetJointOrderType((QuIK::JointOrderType)order);
+
+            // At least a million placements per measurement
+            int numSolves = 1 + 1000000 / numJoints[i];
+
+            std::cout << "  " << orderNames[order] << " " << numJoints[i] << " joints: " 
+                      << TimeSolve(ik, numSolves) << std::endl;
+        }
+    }
+}
+
+// Moving a joint near the start of the chain, which translates the rest of the chain and 
+// recomputes the bone lengths and radii
+static void EditBenchmark() {
+    std::cout << "edit: nanoseconds per joint per edit" << std::endl;
+
+    int numJoints[] = { 64, 1024, 16384 };
+
+    for (int i = 0; i < 3; i++) {
+        QuIK ik;
+        CreateChain(ik, numJoints[i]);
+
+        int numEdits = 1 + 10000000 / numJoints[i];
+
+        double start = Seconds();
+        for (int j = 0; j < numEdits; j++) {
+            ik.SetJointPosition(1, Vec3(1.0, j % 2 == 0 ? 0.5 : -0.5, 0.0));
+        }
+        double elapsed = Seconds() - start;
+
+        std::cout << "  " << numJoints[i] << " joints: " 
+                  << elapsed * 1e9 / ((double)numEdits * numJoints[i]) << std::endl;
+    }
+}
+
+// Very long chains, which must not depend on the depth of the call stack
+static void LongChainBenchmark() {
+    std::cout << "longchain: nanoseconds per joint placement" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    int numJoints = 1000000;
+
+    for (int order = 0; order < 3; order++) {
+        QuIK ik;
+        CreateChain(ik, numJoints);
+        ik.SetJointOrderType((QuIK::JointOrderType)order);
+
+        std::cout << "  " << orderNames[order] << " " << numJoints << " joints: " 
+                  << TimeSolve(ik, 3) << std::endl;
+    }
+}
+
+// Per-placement cost with many joint priorities
+static void PriorityBenchmark() {
+    std::cout << "priorities: nanoseconds per joint placement" << std::endl;
+
+    int numJoints = 16384;
+    int numPriorities[] = { 0, 16, 256, 4096 };
+
+    for (int i = 0; i < 4; i++) {
+        QuIK ik;
+        CreateChain(ik, numJoints);
+        ik.SetJointOrderType(QuIK::DividingJointOrder);
+
+        // Spread the priorities along the chain, in scrambled order
+        for (int j = 0; j < numPriorities[i]; j++) {
+            ik.AddPriority(1 + (j * 7919) % (numJoints - 2));
+        }
+
+        std::cout << "  " << numPriorities[i] << " priorities: " 
+                  << TimeSolve(ik, 100) << std::endl;
+    }
+}
+
+// Serial versus parallel execution of a long dividing solve
+static void ParallelBenchmark() {
+    std::cout << "parallel: nanoseconds per joint placement, " 
+              << ThreadPool::GetGlobal().GetNumThreads() + 1 << " threads" << std::endl;
+
+    const char* executionNames[] = { "serial", "parallel" };
+    int numJoints = 100000;
+
+    for (int execution = 0; execution < 2; execution++) {
+        QuIK ik;
+        CreateChain(ik, numJoints);
+        ik.SetJointOrderType(QuIK::DividingJointOrder);
+        ik.SetExecutionType((QuIK::ExecutionType)execution);
+
+        std::cout << "  " << executionNames[execution] << " " << numJoints << " joints: " 
+                  << TimeSolve(ik, 20) << std::endl;
+    }
+}
+
+// Single-pass versus split solve for a target joint in the middle of the chain
+static void SplitBenchmark() {
+    std::cout << "split: nanoseconds per joint placement, " 
+              << ThreadPool::GetGlobal().GetNumThreads() + 1 << " threads" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* solveNames[] = { "single pass", "split" };
+    int numJoints = 100000;
+
+    for (int order = 0; order < 3; order++) {
+        for (int solve = 0; solve < 2; solve++) {
+            QuIK ik;
+            CreateChain(ik, numJoints);
+            ik.SetJointOrderType((QuIK::JointOrderType)order);
+            ik.SetSolveType((QuIK::SolveType)solve);
+            ik.SetTargetJoint(numJoints / 2);
+
+            std::cout << "  " << orderNames[order] << ", " << solveNames[solve] << ": " 
+                      << TimeSolve(ik, 20) << std::endl;
+        }
+    }
+}
+
+// Thread scaling of a batch of chains with mixed lengths
+static void BatchBenchmark() {
+    int maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = 1;
+
+    std::cout << "batch: milliseconds per batch of 10000 chains, 1 to " 
+              << maxThreads << " threads" << std::endl;
+
+    int numChains = 10000;
+    int numBatches = 10;
+
+    double serialTime = 0.0;
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads++) {
+        // Chains of 4 to 259 joints, the same for every thread count
+        std::vector<QuIK> chains(numChains);
+        std::vector<QuIK*> chainPointers(numChains);
+        std::vector<Vec3> targets(numChains);
+        unsigned int seed = 1;
+        for (int i = 0; i < numChains; i++) {
+            seed = seed * 1664525 + 1013904223;
+            CreateChain(chains[i], 4 + (seed >> 8) % 256);
+            chainPointers[i] = &chains[i];
+        }
+
+        ThreadPool pool(numThreads - 1);
+        QuIKBatch batch;
+        batch.SetThreadPool(&pool);
+
+        double start = Seconds();
+        for (int i = 0; i < numBatches; i++) {
+            for (int j = 0; j < numChains; j++) {
+                double radius = chains[j].GetNumBones() * 0.75;
+                double angle = i * 0.1 + j;
+                targets[j] = Vec3(radius * cos(angle), radius * sin(angle), 0.0);
+            }
+
+            batch.SolveIK(chainPointers, targets);
+        }
+        double elapsed = (Seconds() - start) * 1000.0 / numBatches;
+
+        if (numThreads == 1) serialTime = elapsed;
+
+        // Results do not depend on the number of threads, so neither does the checksum
+        double checksum = 0.0;
+        for (int i = 0; i < numChains; i++) {
+            const std::vector<Vec3>& positions = chains[i].GetPositions();
+            for (int j = 0; j < (int)positions.size(); j++) {
+                checksum += positions[j].x() + positions[j].y();
+            }
+        }
+
+        std::cout << "  " << numThreads << " threads: " << elapsed 
+                  << ", speedup " << serialTime / elapsed 
+                  << ", checksum " << checksum << std::endl;
+    }
+}
+
+// Chains solved one at a time versus in lanes, with the largest difference in joint position
+static void LanesBenchmark() {
+    std::cout << "lanes: nanoseconds per chain solve, " 
+              << QuIKLanes::LaneWidth << " lanes" << std::endl;
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints = 64;
+    int numChains = 1024;
+    int numSolves = 20;
+
+    for (int placement = 0; placement < 2; placement++) {
+        QuIK chain;
+        CreateChain(chain, numJoints);
+        chain.SetJointOrderType(QuIK::DividingJointOrder);
+        chain.SetJointPlacementType((QuIK::JointPlacementType)placement);
+        chain.SetTraceLevel(QuIK::NoTrace);
+
+        std::vector<QuIK> chains(numChains, chain);
+
+        QuIKLanes lanes;
+        lanes.SetChain(chain);
+        lanes.SetNumChains(numChains);
+
+        double radius = numJoints * 0.75;
+
+        double chainTime = 0.0;
+        double laneTime = 0.0;
+        for (int i = 0; i < numSolves; i++) {
+            for (int j = 0; j < numChains; j++) {
+                double angle = i * 0.1 + j;
+                Vec3 target(radius * cos(angle), radius * sin(angle), 0.0);
+
+                chains[j].SetTarget(target);
+                lanes.SetTarget(j, target);
+            }
+
+            double start = Seconds();
+            for (int j = 0; j < numChains; j++) {
+                chains[j].SolveIK();
+            }
+            chainTime += Seconds() - start;
+
+            start = Seconds();
+            lanes.SolveIK();
+            laneTime += Seconds() - start;
+        }
+
+        double difference = 0.0;
+        std::vector<Vec3> positions;
+        for (int i = 0; i < numChains; i++) {
+            lanes.GetJoints(i, positions);
+
+            for (int j = 0; j < numJoints; j++) {
+                difference = std::max(difference, positions[j].Distance(chains[i].GetPositions()[j]));
+            }
+        }
+
+        std::cout << "  " << placementNames[placement] << ", chains: " 
+                  << chainTime * 1e9 / (numSolves * numChains) 
+                  << ", lanes: " << laneTime * 1e9 / (numSolves * numChains) 
+                  << ", difference: " << difference << std::endl;
+    }
+}
+
+// Sphere pairs intersected one at a time versus in a batch, with the number of results that 
+// differ.  Includes touching, concentric and nearly internally tangent pairs, where the circle 
+// position is clamped.
+static void IntersectionBenchmark() {
+    std::cout << "intersection: nanoseconds per sphere pair" << std::endl;
+
+    int numPairs = 4099;
+    int numRepeats = 200;
+
+    std::vector<Sphere> s1(numPairs);
+    std::vector<Sphere> s2(numPairs);
+    srand(1);
+    int numClamped = 0;
+    for (int i = 0; i < numPairs; i++) {
+        Vec3 c1(rand() % 100 * 0.1, rand() % 100 * 0.1, rand() % 100 * 0.1);
+        Vec3 c2(rand() % 100 * 0.1, rand() % 100 * 0.1, rand() % 100 * 0.1);
+        double r1 = 0.5 + rand() % 100 * 0.1;
+        double r2 = 0.5 + rand() % 100 * 0.1;
+
+        switch (i % 8) {
+            case 0: c2 = c1 + Vec3(r1 + r2, 0.0, 0.0); break;
+            case 1: c2 = c1; break;
+            case 2: c2 = c1; r2 = r1; break;
+            case 3: r2 = r1 - c1.Distance(c2); break;
+        }
+
+        s1[i].Set(c1, r1);
+        s2[i].Set(c2, r2);
+
+        double d = c1.Distance(c2);
+        if (d > 0.0 && fabs((d * d - r2 * r2 + r1 * r1) / (2.0 * d)) > r1) numClamped++;
+    }
+
+    // Single intersections
+    std::vector<Sphere::SSI_Type> type(numPairs);
+    std::vector<Vec3> c(numPairs);
+    std::vector<double> r(numPairs);
+    std::vector<Vec3> n(numPairs);
+
+    double start = Seconds();
+    for (int j = 0; j < numRepeats; j++) {
+        for (int i = 0; i < numPairs; i++) {
+            type[i] = s1[i].Intersection(s2[i], c[i], r[i], n[i]);
+        }
+    }
+    double singleTime = Seconds() - start;
+
+    // Batch intersections
+    std::vector<double> x1(numPairs), y1(numPairs), z1(numPairs), r1(numPairs);
+    std::vector<double> x2(numPairs), y2(numPairs), z2(numPairs), r2(numPairs);
+    for (int i = 0; i < numPairs; i++) {
+        x1[i] = s1[i].c().x(); y1[i] = s1[i].c().y(); z1[i] = s1[i].c().z(); r1[i] = s1[i].r();
+        x2[i] = s2[i].c().x(); y2[i] = s2[i].c().y(); z2[i] = s2[i].c().z(); r2[i] = s2[i].r();
+    }
+
+    std::vector<Sphere::SSI_Type> batchType(numPairs);
+    std::vector<double> cx(numPairs), cy(numPairs), cz(numPairs), cr(numPairs);
+    std::vector<double> nx(numPairs), ny(numPairs), nz(numPairs);
+
+    Sphere::SphereArrays a1 = { x1.data(), y1.data(), z1.data(), r1.data() };
+    Sphere::SphereArrays a2 = { x2.data(), y2.data(), z2.data(), r2.data() };
+    Sphere::IntersectionArrays result = { batchType.data(), cx.data(), cy.data(), cz.data(), cr.data(), 
+                                          nx.data(), ny.data(), nz.data() };
+
+    start = Seconds();
+    for (int j = 0; j < numRepeats; j++) {
+        Sphere::Intersection(numPairs, a1, a2, result);
+    }
+    double batchTime = Seconds() - start;
+
+    // Compare bitwise, other than the radius of empty intersections, which is unused
+    int numDifferent = 0;
+    for (int i = 0; i < numPairs; i++) {
+        if (batchType[i] != type[i] ||
+            !(Vec3(cx[i], cy[i], cz[i]) == c[i]) ||
+            !(Vec3(nx[i], ny[i], nz[i]) == n[i]) ||
+            !(cr[i] == r[i] || (isnan(cr[i]) && isnan(r[i])))) {
+            numDifferent++;
+        }
+    }
+
+    std::cout << "  single: " << singleTime * 1e9 / (numRepeats * numPairs) 
+              << ", batch: " << batchTime * 1e9 / (numRepeats * numPairs) 
+              << ", clamped: " << numClamped 
+              << ", different: " << numDifferent << std::endl;
+}
+
+// Solving one chain for many targets, restoring the joints in between versus all at once
+static void TargetsBenchmark() {
+    std::cout << "targets: nanoseconds per target, " 
+              << ThreadPool::GetGlobal().GetNumThreads() + 1 << " threads" << std::endl;
+
+    int numJoints[] = { 8, 64, 1024 };
+    int numTargets = 4096;
+
+    for (int i = 0; i < 3; i++) {
+        QuIK ik;
+        CreateChain(ik, numJoints[i]);
+        ik.SetJointOrderType(QuIK::DividingJointOrder);
+        ik.SetTargetJoint(numJoints[i] / 2);
+
+        std::vector<Vec3> joints = ik.GetPositions();
+
+        double radius = numJoints[i] * 0.5;
+        std::vector<Vec3> targets(numTargets);
+        for (int j = 0; j < numTargets; j++) {
+            targets[j] = Vec3(radius * cos(j * 0.1), radius * sin(j * 0.1), 0.0);
+        }
+
+        // One target at a time
+        std::vector<Vec3> poses(numTargets * numJoints[i]);
+
+        double start = Seconds();
+        for (int j = 0; j < numTargets; j++) {
+            ik.SetJoints(joints);
+            ik.SetTargetJoint(numJoints[i] / 2);
+            ik.SetTarget(targets[j]);
+            ik.SolveIK();
+
+            std::copy(ik.GetPositions().begin(), ik.GetPositions().end(), poses.begin() + j * numJoints[i]);
+        }
+        double loopTime = Seconds() - start;
+
+        ik.SetJoints(joints);
+        ik.SetTargetJoint(numJoints[i] / 2);
+
+        // All targets
+        std::vector<Vec3> batchPoses(numTargets * numJoints[i]);
+
+        start = Seconds();
+        ik.SolveIK(&targets[0], numTargets, &batchPoses[0]);
+        double batchTime = Seconds() - start;
+
+        bool same = true;
+        for (int j = 0; j < (int)poses.size(); j++) {
+            if (poses[j].Distance(batchPoses[j]) != 0.0) same = false;
+        }
+
+        std::cout << "  " << numJoints[i] << " joints, one at a time: " << loopTime * 1e9 / numTargets 
+                  << ", all at once: " << batchTime * 1e9 / numTargets 
+                  << (same ? ", same poses" : ", different poses") << std::endl;
+    }
+}
+
+// Largest errors of a chain solved with another scalar type against doubles, relative to the 
+// chain length.  Each solve starts from the same joints.
+struct ScalarErrors {
+    double position;    // Distance of a joint from the double joint
+    double length;      // Change in a bone length
+    double effector;    // Difference in the distance of the end effector from the target
+};
+
+template <class T>
+static ScalarErrors GetScalarErrors(int numJoints, QuIK::JointPlacementType placement, int numSolves) {
+    QuIK ik;
+    CreateChain(ik, numJoints);
+    ik.SetJointOrderType(QuIK::DividingJointOrder);
+    ik.SetJointPlacementType(placement);
+
+    QuIKT<T> ikScalar;
+    CreateChain(ikScalar, numJoints);
+    ikScalar.SetJointOrderType(QuIKT<T>::DividingJointOrder);
+    ikScalar.SetJointPlacementType((typename QuIKT<T>::JointPlacementType)placement);
+
+    std::vector<Vec3> joints = ik.GetPositions();
+    std::vector<Vec3T<T> > jointsScalar = ikScalar.GetPositions();
+    std::vector<double> lengths = ik.GetLengths();
+
+    double chainLength = 0.0;
+    for (int j = 0; j < (int)lengths.size(); j++) {
+        chainLength += lengths[j];
+    }
+
+    double radius = numJoints * 0.75;
+    int last = numJoints - 1;
+
+    ScalarErrors errors = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < numSolves; j++) {
+        double angle = j * 0.1;
+        Vec3 target(radius * cos(angle), radius * sin(angle), 0.0);
+
+        ik.SetJoints(joints);
+        ik.SetTarget(target);
+        ik.SolveIK();
+
+        ikScalar.SetJoints(jointsScalar);
+        ikScalar.SetTarget(Vec3T<T>(T(target.x()), T(target.y()), T(target.z())));
+        ikScalar.SolveIK();
+
+        const std::vector<Vec3>& p = ik.GetPositions();
+        const std::vector<Vec3T<T> >& q = ikScalar.GetPositions();
+
+        for (int k = 0; k < numJoints; k++) {
+            Vec3 v((double)q[k].x(), (double)q[k].y(), (double)q[k].z());
+
+            errors.position = std::max(errors.position, v.Distance(p[k]));
+
+            if (k > 0) {
+                Vec3 u((double)q[k - 1].x(), (double)q[k - 1].y(), (double)q[k - 1].z());
+
+                errors.length = std::max(errors.length, fabs(v.Distance(u) - lengths[k - 1]));
+            }
+
+            if (k == last) {
+                errors.effector = std::max(errors.effector, fabs(v.Distance(target) - p[k].Distance(target)));
+            }
+        }
+    }
+
+    errors.position /= chainLength;
+    errors.length /= chainLength;
+    errors.effector /= chainLength;
+
+    return errors;
+}
+
+// Chains solved with another scalar type versus doubles
+template <class T>
+static void ScalarBenchmark(const char* name) {
+    std::cout << name << ": nanoseconds per joint placement, double versus " << name << std::endl;
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints[] = { 8, 64, 1024 };
+    int numSolves = 200;
+
+    for (int placement = 0; placement < 2; placement++) {
+        for (int i = 0; i < 3; i++) {
+            QuIK ik;
+            CreateChain(ik, numJoints[i]);
+            ik.SetJointOrderType(QuIK::DividingJointOrder);
+            ik.SetJointPlacementType((QuIK::JointPlacementType)placement);
+
+            QuIKT<T> ikScalar;
+            CreateChain(ikScalar, numJoints[i]);
+            ikScalar.SetJointOrderType(QuIKT<T>::DividingJointOrder);
+            ikScalar.SetJointPlacementType((typename QuIKT<T>::JointPlacementType)placement);
+
+            ScalarErrors errors = GetScalarErrors<T>(numJoints[i], (QuIK::JointPlacementType)placement, numSolves);
+
+            std::cout << "  " << placementNames[placement] << ", " << numJoints[i] << " joints, double: " 
+                      << TimeSolve(ik, numSolves) 
+                      << ", " << name << ": " << TimeSolve(ikScalar, numSolves) 
+                      << ", position error: " << errors.position 
+                      << ", length error: " << errors.length 
+                      << ", effector error: " << errors.effector << std::endl;
+        }
+    }
+}
+
+// Per-solve cost of a chain of N joints with the dynamic solver and the compile-time one, 
+// which follow the same targets from the same chain, and the largest distance between their 
+// joints, which should be zero
+template <int N, QuIK::JointOrderType Order>
+static void StaticChainBenchmark(const char* orderName) {
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numSolves = 1000000;
+
+    for (int placement = 0; placement < 2; placement++) {
+        QuIK ik;
+        CreateChain(ik, N);
+        ik.SetJointOrderType(Order);
+        ik.SetJointPlacementType((QuIK::JointPlacementType)placement);
+        ik.SetTraceLevel(QuIK::NoTrace);
+
+        StaticQuIK<N, Order> ikStatic;
+        std::array<Vec3, N> joints;
+        std::copy(ik.GetPositions().begin(), ik.GetPositions().end(), joints.begin());
+        ikStatic.SetJoints(joints);
+        ikStatic.SetJointPlacementType((QuIK::JointPlacementType)placement);
+
+        double radius = (N - 1) * 0.75;
+
+        double start = Seconds();
+        for (int i = 0; i < numSolves; i++) {
+            double angle = i * 0.1;
+            ik.SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+            ik.SolveIK();
+        }
+        double dynamicTime = Seconds() - start;
+
+        start = Seconds();
+        for (int i = 0; i < numSolves; i++) {
+            double angle = i * 0.1;
+            ikStatic.SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+            ikStatic.SolveIK();
+        }
+        double staticTime = Seconds() - start;
+
+        double difference = 0.0;
+        for (int i = 0; i < N; i++) {
+            difference = std::max(difference, ik.GetPositions()[i].Distance(ikStatic.GetPositions()[i]));
+        }
+
+        std::cout << "  " << orderName << ", " << placementNames[placement] << ", " << N << " joints, dynamic: " 
+                  << dynamicTime * 1e9 / numSolves 
+                  << ", static: " << staticTime * 1e9 / numSolves 
+                  << ", difference: " << difference << std::endl;
+    }
+}
+
+// Small chains solved by QuIK and by StaticQuIK.  The static solver saves the plan lookups,
+// which matter at 3 and 4 joints, but both share the placement functions, so at 7 joints
+// the times are within the noise.
+static void StaticBenchmark() {
+    std::cout << "static: nanoseconds per solve, dynamic versus static" << std::endl;
+
+    StaticChainBenchmark<3, QuIK::DividingJointOrder>("dividing");
+    StaticChainBenchmark<4, QuIK::DividingJointOrder>("dividing");
+    StaticChainBenchmark<7, QuIK::DividingJointOrder>("dividing");
+    StaticChainBenchmark<7, QuIK::IncreasingJointOrder>("increasing");
+    StaticChainBenchmark<7, QuIK::DecreasingJointOrder>("decreasing");
+}
+
+// Planar chains solved in 3D and in 2D.  The difference is the largest distance between a 
+// 2D joint and the 3D joint, which should be zero, and the memory is the size of the joint 
+// positions per joint.
+static void PlanarBenchmark() {
+    std::cout << "planar: nanoseconds per joint placement, 3D versus 2D" << std::endl;
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints[] = { 8, 64, 1024 };
+
+    for (int placement = 0; placement < 2; placement++) {
+        for (int i = 0; i < 3; i++) {
+            QuIK ik;
+            CreateChain(ik, numJoints[i]);
+            ik.SetJointOrderType(QuIK::DividingJointOrder);
+            ik.SetJointPlacementType((QuIK::JointPlacementType)placement);
+
+            QuIK2D ik2D;
+            CreateChain(ik2D, numJoints[i]);
+            ik2D.SetJointOrderType(QuIK2D::DividingJointOrder);
+            ik2D.SetJointPlacementType((QuIK2D::JointPlacementType)placement);
+
+            // At least a million placements per measurement
+            int numSolves = 1 + 1000000 / numJoints[i];
+
+            double time = TimeSolve(ik, numSolves);
+            double time2D = TimeSolve(ik2D, numSolves);
+
+            double difference = 0.0;
+            for (int j = 0; j < numJoints[i]; j++) {
+                const Vec3& p = ik.GetPositions()[j];
+                const Vec2& q = ik2D.GetPositions()[j];
+
+                difference = std::max(difference, Vec3(q.x(), q.y(), 0.0).Distance(p));
+            }
+
+            std::cout << "  " << placementNames[placement] << ", " << numJoints[i] << " joints, 3D: " 
+                      << time << ", 2D: " << time2D 
+                      << ", difference: " << difference 
+                      << ", bytes per joint: " << 2 * sizeof(Vec3) << " versus " << 2 * sizeof(Vec2) << std::endl;
+        }
+    }
+}
+
+// Solving for a target that moves a little at a time, with full and incremental updates.  The 
+// target moves every solve, or every tenth solve as when it is dragged and held.
+static void IncrementalBenchmark() {
+    std::cout << "incremental: microseconds per solve, full versus incremental update" << std::endl;
+
+    const char* motionNames[] = { "moving", "held" };
+    int motionSteps[] = { 1, 10 };
+    int numJoints[] = { 64, 1024, 16384 };
+
+    for (int motion = 0; motion < 2; motion++) {
+        for (int i = 0; i < 3; i++) {
+            QuIK ik[2];
+            for (int j = 0; j < 2; j++) {
+                CreateChain(ik[j], numJoints[i]);
+                ik[j].SetJointOrderType(QuIK::DividingJointOrder);
+                ik[j].SetJointPlacementType(QuIK::InertialJointPlacement);
+            }
+            ik[1].SetUpdateType(QuIK::IncrementalUpdate);
+
+            // At least a million placements per measurement
+            int numSolves = 1 + 1000000 / numJoints[i];
+            double radius = numJoints[i] * 0.75;
+
+            double time[2];
+            long numSkipped = 0;
+            long numPlacements = 0;
+            for (int j = 0; j < 2; j++) {
+                double start = Seconds();
+                for (int k = 0; k < numSolves; k++) {
+                    double angle = (k / motionSteps[motion]) * 0.001;
+                    ik[j].SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+                    ik[j].SolveIK();
+
+                    if (j == 1) {
+                        numSkipped += ik[j].GetNumPlacementsSkipped();
+                        numPlacements += ik[j].GetPlan().GetNumPlacements();
+                    }
+                }
+                time[j] = (Seconds() - start) * 1e6 / numSolves;
+            }
+
+            double difference = 0.0;
+            for (int j = 0; j < numJoints[i]; j++) {
+                difference = std::max(difference, ik[0].GetPositions()[j].Distance(ik[1].GetPositions()[j]));
+            }
+
+            std::cout << "  " << motionNames[motion] << ", " << numJoints[i] << " joints, full: " 
+                      << time[0] << ", incremental: " << time[1] 
+                      << ", placements skipped: " << 100.0 * numSkipped / numPlacements << "%"
+                      << ", difference: " << difference << std::endl;
+        }
+    }
+}
+
+// Reading just the end effector and the middle joint after each solve, with full and lazy 
+// updates.  The error is the largest distance of the end effector from the target.  Over a 
+// shorter sequence of the same targets, the difference is the largest distance of any joint 
+// from a full update when every joint is read after each solve, and the drift is the largest 
+// distance of any joint at the end when just the two joints are read.
+static void LazyBenchmark() {
+    std::cout << "lazy: microseconds per solve, full versus lazy update" << std::endl;
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints[] = { 64, 1024, 16384 };
+
+    for (int placement = 0; placement < 2; placement++) {
+        for (int i = 0; i < 3; i++) {
+            // At least a million placements per measurement for the full update
+            int numSolves = 1 + 1000000 / numJoints[i];
+            double radius = numJoints[i] * 0.75;
+
+            int last = numJoints[i] - 1;
+            int middle = last / 2;
+
+            double time[2];
+            double error[2];
+            long numPlaced = 0;
+            long numPlacements = 0;
+            for (int j = 0; j < 2; j++) {
+                QuIK ik;
+                CreateChain(ik, numJoints[i]);
+                ik.SetJointOrderType(QuIK::DividingJointOrder);
+                ik.SetJointPlacementType((QuIK::JointPlacementType)placement);
+                ik.SetUpdateType(j == 0 ? QuIK::FullUpdate : QuIK::LazyUpdate);
+
+                // Compile the plan
+                ik.GetPlan();
+
+                error[j] = 0.0;
+
+                double start = Seconds();
+                for (int k = 0; k < numSolves; k++) {
+                    double angle = k * 0.01;
+                    Vec3 target(radius * cos(angle), radius * sin(angle), 0.0);
+                    ik.SetTarget(target);
+                    ik.SolveIK();
+
+                    Vec3 p = ik.GetPosition(last);
+                    ik.GetPosition(middle);
+
+                    error[j] = std::max(error[j], p.Distance(target));
+
+                    if (j == 1) {
+                        numPlaced += ik.GetNumPlacementsMade();
+                        numPlacements += ik.GetPlan().GetNumPlacements();
+                    }
+                }
+                time[j] = (Seconds() - start) * 1e6 / numSolves;
+            }
+
+            // Full update, lazy update reading every joint, and lazy update reading two joints
+            QuIK ik[3];
+            for (int j = 0; j < 3; j++) {
+                CreateChain(ik[j], numJoints[i]);
+                ik[j].SetJointOrderType(QuIK::DividingJointOrder);
+                ik[j].SetJointPlacementType((QuIK::JointPlacementType)placement);
+                ik[j].SetUpdateType(j == 0 ? QuIK::FullUpdate : QuIK::LazyUpdate);
+            }
+
+            double difference = 0.0;
+            for (int k = 0; k < 100; k++) {
+                double angle = k * 0.01;
+                Vec3 target(radius * cos(angle), radius * sin(angle), 0.0);
+
+                for (int j = 0; j < 3; j++) {
+                    ik[j].SetTarget(target);
+                    ik[j].SolveIK();
+                }
+
+                ik[2].GetPosition(last);
+                ik[2].GetPosition(middle);
+
+                for (int j = 0; j < numJoints[i]; j++) {
+                    difference = std::max(difference, ik[0].GetPositions()[j].Distance(ik[1].GetPositions()[j]));
+                }
+            }
+
+            double drift = 0.0;
+            for (int j = 0; j < numJoints[i]; j++) {
+                drift = std::max(drift, ik[0].GetPositions()[j].Distance(ik[2].GetPositions()[j]));
+            }
+
+            std::cout << "  " << placementNames[placement] << ", " << numJoints[i] << " joints, full: " 
+                      << time[0] << ", lazy: " << time[1] 
+                      << ", placements made: " << 100.0 * numPlaced / numPlacements << "%"
+                      << ", error: " << error[0] << " versus " << error[1] 
+                      << ", difference: " << difference << ", drift: " << drift << std::endl;
+        }
+    }
+}
+
+// Heap allocations per solve once the solver has warmed up, which must be zero.  Returns 
+// whether none of the solves allocated.
+static bool AllocationCheck() {
+    std::cout << "alloc: heap allocations per steady-state solve" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* traceNames[] = { "no trace", "joint order trace" };
+    const char* updateNames[] = { "full update", "incremental update", "lazy update" };
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int trace = 0; trace < 2; trace++) {
+            for (int update = 0; update < 3; update++) {
+                QuIK ik;
+                CreateChain(ik, 256);
+                ik.SetJointOrderType((QuIK::JointOrderType)order);
+                ik.SetTraceLevel((QuIK::TraceLevel)trace);
+                ik.SetUpdateType((QuIK::UpdateType)update);
+                ik.AddPriority(100);
+                ik.AddPriority(20);
+                ik.SetTargetJoint(128);
+
+                // Warm up
+                TimeSolve(ik, 1);
+                ik.GetPositions();
+
+                long before = GetNumAllocations();
+                TimeSolve(ik, 1000);
+                ik.GetPositions();
+
+                long numAllocations = GetNumAllocations() - before;
+                if (numAllocations > 0) passed = false;
+
+                std::cout << "  " << orderNames[order] << ", " << traceNames[trace] << ", " << updateNames[update] << ": " 
+                          << numAllocations / 1000.0 
+                          << (numAllocations > 0 ? "  FAILED" : "") << std::endl;
+            }
+        }
+    }
+
+    return passed;
+}
+
+// Error of a float radius from the exact radius, in roundings of the bone lengths it sums
+static double RadiusError(float radius, double exact, double magnitude) {
+    return fabs(radius - exact) / (FLT_EPSILON * magnitude);
+}
+
+// Reach from every 61st joint and the last joint of float chains, against summing the bone 
+// lengths directly in double, which must be within two roundings.  Returns whether it is.
+static bool ReachCheck() {
+    std::cout << "reach: largest error of float reach, in roundings of the summed lengths" << std::endl;
+
+    int numJoints[] = { 64, 1024, 16384 };
+
+    bool passed = true;
+    for (int i = 0; i < 3; i++) {
+        QuIKT<float> ik;
+        CreateChain(ik, numJoints[i]);
+        const std::vector<float>& lengths = ik.GetLengths();
+
+        double error = 0.0;
+        for (int j = 0; j < numJoints[i]; j++) {
+            if (j % 61 != 0 && j != numJoints[i] - 1) continue;
+
+            // Toward the last joint, adding each bone between the two joints
+            double between = 0.0;
+            for (int k = j + 1; k < numJoints[i]; k++) {
+                if (k > j + 1) between += lengths[k - 1];
+
+                double magnitude = lengths[j] + between;
+                error = std::max(error, RadiusError(ik.GetMaxRadius(j, k), lengths[j] + between, magnitude));
+                error = std::max(error, RadiusError(ik.GetMinRadius(j, k), lengths[j] - between, magnitude));
+            }
+
+            // Toward the first joint
+            between = 0.0;
+            for (int k = j - 1; k >= 0; k--) {
+                if (k < j - 1) between += lengths[k];
+
+                double magnitude = lengths[j - 1] + between;
+                error = std::max(error, RadiusError(ik.GetMaxRadius(j, k), lengths[j - 1] + between, magnitude));
+                error = std::max(error, RadiusError(ik.GetMinRadius(j, k), lengths[j - 1] - between, magnitude));
+            }
+        }
+
+        if (error > 2.0) passed = false;
+
+        std::cout << "  " << numJoints[i] << " joints: " << error 
+                  << (error > 2.0 ? "  FAILED" : "") << std::endl;
+    }
+
+    return passed;
+}
+
+// Batch intersections against the member function for one scalar and dimension, with the same 
+// kinds of pairs as the intersection benchmark.  Returns the number of pairs that differ.
+template <class T, int D>
+static int IntersectionDifferences() {
+    typedef SphereT<T, D> SphereType;
+    typedef VecT<T, D> VecType;
+
+    int numPairs = 4099;
+
+    std::vector<T> x1(numPairs), y1(numPairs), z1(numPairs), r1(numPairs);
+    std::vector<T> x2(numPairs), y2(numPairs), z2(numPairs), r2(numPairs);
+    srand(1);
+    for (int i = 0; i < numPairs; i++) {
+        x1[i] = T(rand() % 100 * 0.1); y1[i] = T(rand() % 100 * 0.1); z1[i] = D == 3 ? T(rand() % 100 * 0.1) : T(0);
+        x2[i] = T(rand() % 100 * 0.1); y2[i] = T(rand() % 100 * 0.1); z2[i] = D == 3 ? T(rand() % 100 * 0.1) : T(0);
+        r1[i] = T(0.5 + rand() % 100 * 0.1);
+        r2[i] = T(0.5 + rand() % 100 * 0.1);
+
+        switch (i % 8) {
+            case 0: x2[i] = x1[i] + r1[i] + r2[i]; y2[i] = y1[i]; z2[i] = z1[i]; break;
+            case 1: x2[i] = x1[i]; y2[i] = y1[i]; z2[i] = z1[i]; break;
+            case 2: x2[i] = x1[i]; y2[i] = y1[i]; z2[i] = z1[i]; r2[i] = r1[i]; break;
+        }
+    }
+
+    std::vector<typename SphereType::SSI_Type> type(numPairs);
+    std::vector<T> cx(numPairs), cy(numPairs), cz(numPairs), cr(numPairs);
+    std::vector<T> nx(numPairs), ny(numPairs), nz(numPairs);
+
+    typename SphereType::SphereArrays a1 = { x1.data(), y1.data(), z1.data(), r1.data() };
+    typename SphereType::SphereArrays a2 = { x2.data(), y2.data(), z2.data(), r2.data() };
+    typename SphereType::IntersectionArrays result = { type.data(), cx.data(), cy.data(), cz.data(), cr.data(), 
+                                                       nx.data(), ny.data(), nz.data() };
+
+    SphereType::Intersection(numPairs, a1, a2, result);
+
+    // Compare bitwise, with NaN radii equal
+    int numDifferent = 0;
+    for (int i = 0; i < numPairs; i++) {
+        VecType c1 = PlanePoint<T, D>(0.0, 0.0);
+        VecType c2 = c1;
+        c1[0] = x1[i]; c1[1] = y1[i];
+        c2[0] = x2[i]; c2[1] = y2[i];
+        if (D == 3) {
+            c1[D - 1] = z1[i];
+            c2[D - 1] = z2[i];
+        }
+
+        VecType c;
+        T r;
+        VecType n;
+        typename SphereType::SSI_Type singleType = SphereType(c1, r1[i]).Intersection(SphereType(c2, r2[i]), c, r, n);
+
+        bool same = singleType == type[i] && 
+                    c[0] == cx[i] && c[1] == cy[i] && (D == 2 || c[D - 1] == cz[i]) &&
+                    n[0] == nx[i] && n[1] == ny[i] && (D == 2 || n[D - 1] == nz[i]) &&
+                    (r == cr[i] || (r != r && cr[i] != cr[i]));
+        if (!same) numDifferent++;
+    }
+
+    return numDifferent;
+}
+
+// Batch intersections against the member function for every scalar and dimension, which must 
+// match bitwise.  Returns whether they do.
+static bool IntersectionCheck() {
+    std::cout << "intersect: batch intersections different from the member function" << std::endl;
+
+    const char* names[] = { "float 2D", "double 2D", "fixed 2D", "float 3D", "double 3D", "fixed 3D" };
+    int numDifferent[] = { 
+        IntersectionDifferences<float, 2>(), IntersectionDifferences<double, 2>(), IntersectionDifferences<Fixed, 2>(),
+        IntersectionDifferences<float, 3>(), IntersectionDifferences<double, 3>(), IntersectionDifferences<Fixed, 3>() 
+    };
+
+    bool passed = true;
+    for (int i = 0; i < 6; i++) {
+        if (numDifferent[i] > 0) passed = false;
+
+        std::cout << "  " << names[i] << ": " << numDifferent[i] 
+                  << (numDifferent[i] > 0 ? "  FAILED" : "") << std::endl;
+    }
+
+    return passed;
+}
+
+// An array of constraints of mixed types held by value, against the sphere, interior and 
+// exterior types they were made from, which must match.  Returns whether they do.
+static bool ConstraintCheck() {
+    std::cout << "constraints: mixed constraints different from the sphere types" << std::endl;
+
+    int numConstraints = 999;
+    int numPoints = 100;
+
+    std::vector<Vec3> c(numConstraints);
+    std::vector<double> r(numConstraints);
+    std::vector<SphereConstraint> constraints(numConstraints);
+    srand(1);
+    for (int i = 0; i < numConstraints; i++) {
+        c[i] = Vec3(rand() % 100 * 0.1, rand() % 100 * 0.1, rand() % 100 * 0.1);
+        r[i] = 0.5 + rand() % 100 * 0.1;
+
+        switch (i % 3) {
+            case 0: constraints[i] = SphereConstraint(Sphere(c[i], r[i])); break;
+            case 1: constraints[i] = SphereConstraint(SphereInterior(c[i], r[i])); break;
+            case 2: constraints[i] = SphereConstraint(SphereExterior(c[i], r[i])); break;
+        }
+    }
+
+    int numDifferent = 0;
+    for (int j = 0; j < numPoints; j++) {
+        Vec3 p(rand() % 100 * 0.1, rand() % 100 * 0.1, rand() % 100 * 0.1);
+
+        for (int i = 0; i < numConstraints; i++) {
+            Vec3 closest;
+            bool valid = false;
+
+            switch (i % 3) {
+                case 0: closest = Sphere(c[i], r[i]).ClosestPoint(p); valid = Sphere(c[i], r[i]).IsValid(p); break;
+                case 1: closest = SphereInterior(c[i], r[i]).ClosestPoint(p); valid = SphereInterior(c[i], r[i]).IsValid(p); break;
+                case 2: closest = SphereExterior(c[i], r[i]).ClosestPoint(p); valid = SphereExterior(c[i], r[i]).IsValid(p); break;
+            }
+
+            if (!(constraints[i].ClosestPoint(p) == closest) || constraints[i].IsValid(p) != valid) numDifferent++;
+        }
+    }
+
+    std::cout << "  different: " << numDifferent 
+              << (numDifferent > 0 ? "  FAILED" : "") << std::endl;
+
+    return numDifferent == 0;
+}
+
+// Number of joints different between serial and parallel solves of the same chain, each 
+// solved for the same 20 targets
+static int ParallelDifferences(int numJoints, QuIK::JointPlacementType placement, ThreadPool* pool) {
+    QuIK ik[2];
+    for (int j = 0; j < 2; j++) {
+        CreateChain(ik[j], numJoints);
+        ik[j].SetJointOrderType(QuIK::DividingJointOrder);
+        ik[j].SetJointPlacementType(placement);
+        ik[j].AddPriority(numJoints / 3);
+    }
+    ik[1].SetExecutionType(QuIK::ParallelExecution);
+    ik[1].SetThreadPool(pool);
+    ik[1].SetGrainSize(4);
+
+    double radius = numJoints * 0.75;
+
+    int numDifferent = 0;
+    for (int k = 0; k < 20; k++) {
+        double angle = k * 0.1;
+        for (int j = 0; j < 2; j++) {
+            ik[j].SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+            ik[j].SolveIK();
+        }
+
+        numDifferent += NumDifferent(ik[0].GetPositions(), ik[1].GetPositions());
+    }
+
+    return numDifferent;
+}
+
+// Parallel dividing solves against serial ones, which must match bitwise.  Uses a pool of 
+// several threads and a small grain, so intervals are stolen by other threads and the start 
+// joints they share are deferred.  Also solves from two threads outside the pool at once, 
+// each with its own queue.  Returns whether they match.
+static bool ParallelCheck() {
+    std::cout << "same-parallel: joints different from a serial solve, 4 threads" << std::endl;
+
+    ThreadPool pool(3);
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints[] = { 64, 1000, 10000 };
+
+    bool passed = true;
+    for (int placement = 0; placement < 2; placement++) {
+        for (int i = 0; i < 3; i++) {
+            int numDifferent = ParallelDifferences(numJoints[i], (QuIK::JointPlacementType)placement, &pool);
+
+            passed = ReportDifferences(std::string(placementNames[placement]) + ", " + std::to_string(numJoints[i]) + " joints", 
+                                       numDifferent) && passed;
+        }
+    }
+
+    // Two callers sharing the pool
+    for (int placement = 0; placement < 2; placement++) {
+        int numDifferent[2];
+        std::thread callers[2];
+        for (int j = 0; j < 2; j++) {
+            callers[j] = std::thread([&numDifferent, &pool, placement, j] {
+                numDifferent[j] = ParallelDifferences(10000, (QuIK::JointPlacementType)placement, &pool);
+            });
+        }
+        for (int j = 0; j < 2; j++) {
+            callers[j].join();
+        }
+
+        passed = ReportDifferences(std::string(placementNames[placement]) + ", 10000 joints, two callers", 
+                                   numDifferent[0] + numDifferent[1]) && passed;
+    }
+
+    return passed;
+}
+
+// Split solves against single pass ones for a target joint in the middle of the chain, which 
+// must match bitwise.  Uses a pool of several threads and a small grain.  Returns whether 
+// they match.
+static bool SplitCheck() {
+    std::cout << "same-split: joints different from a single pass solve, 4 threads" << std::endl;
+
+    ThreadPool pool(3);
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints = 1000;
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int placement = 0; placement < 2; placement++) {
+            QuIK ik[2];
+            for (int j = 0; j < 2; j++) {
+                CreateChain(ik[j], numJoints);
+                ik[j].SetJointOrderType((QuIK::JointOrderType)order);
+                ik[j].SetJointPlacementType((QuIK::JointPlacementType)placement);
+                ik[j].SetTargetJoint(numJoints / 2);
+            }
+            ik[1].SetSolveType(QuIK::SplitSolve);
+            ik[1].SetThreadPool(&pool);
+            ik[1].SetGrainSize(4);
+
+            double radius = numJoints * 0.5;
+
+            int numDifferent = 0;
+            for (int k = 0; k < 20; k++) {
+                double angle = k * 0.1;
+                for (int j = 0; j < 2; j++) {
+                    ik[j].SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+                    ik[j].SolveIK();
+                }
+
+                numDifferent += NumDifferent(ik[0].GetPositions(), ik[1].GetPositions());
+            }
+
+            passed = ReportDifferences(std::string(orderNames[order]) + ", " + placementNames[placement], numDifferent) && passed;
+        }
+    }
+
+    return passed;
+}
+
+// Chains solved in a batch against the same chains solved one at a time, which must match 
+// bitwise.  Uses a pool of several threads and a small grain, so the chains are split into 
+// many chunks.  Returns whether they match.
+static bool BatchCheck() {
+    std::cout << "same-batch: joints different from solving each chain, 4 threads" << std::endl;
+
+    ThreadPool pool(3);
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numChains = 300;
+
+    bool passed = true;
+    for (int placement = 0; placement < 2; placement++) {
+        // Chains of 4 to 67 joints
+        std::vector<QuIK> chains(numChains);
+        std::vector<QuIK*> chainPointers(numChains);
+        unsigned int seed = 1;
+        for (int i = 0; i < numChains; i++) {
+            seed = seed * 1664525 + 1013904223;
+            CreateChain(chains[i], 4 + (seed >> 8) % 64);
+            chains[i].SetJointOrderType((QuIK::JointOrderType)(i % 3));
+            chains[i].SetJointPlacementType((QuIK::JointPlacementType)placement);
+            chainPointers[i] = &chains[i];
+        }
+        std::vector<QuIK> serialChains = chains;
+
+        QuIKBatch batch;
+        batch.SetThreadPool(&pool);
+        batch.SetGrainSize(64);
+
+        std::vector<Vec3> targets(numChains);
+
+        int numDifferent = 0;
+        for (int k = 0; k < 10; k++) {
+            for (int i = 0; i < numChains; i++) {
+                double radius = chains[i].GetNumBones() * 0.75;
+                double angle = k * 0.1 + i;
+                targets[i] = Vec3(radius * cos(angle), radius * sin(angle), 0.0);
+
+                serialChains[i].SetTarget(targets[i]);
+                serialChains[i].SolveIK();
+            }
+
+            batch.SolveIK(chainPointers, targets);
+
+            for (int i = 0; i < numChains; i++) {
+                numDifferent += NumDifferent(serialChains[i].GetPositions(), chains[i].GetPositions());
+            }
+        }
+
+        passed = ReportDifferences(placementNames[placement], numDifferent) && passed;
+    }
+
+    return passed;
+}
+
+// Chains solved in lanes against the same chains solved one at a time, which must match 
+// bitwise.  The number of chains does not fill the last block.  Returns whether they match.
+static bool LanesCheck() {
+    std::cout << "same-lanes: joints different from solving each chain, " 
+              << QuIKLanes::LaneWidth << " lanes" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints = 64;
+    int numChains = 8 * QuIKLanes::LaneWidth + 1;
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int placement = 0; placement < 2; placement++) {
+            QuIK chain;
+            CreateChain(chain, numJoints);
+            chain.SetJointOrderType((QuIK::JointOrderType)order);
+            chain.SetJointPlacementType((QuIK::JointPlacementType)placement);
+
+            std::vector<QuIK> chains(numChains, chain);
+
+            QuIKLanes lanes;
+            lanes.SetChain(chain);
+            lanes.SetNumChains(numChains);
+
+            double radius = numJoints * 0.75;
+
+            int numDifferent = 0;
+            std::vector<Vec3> positions;
+            for (int k = 0; k < 10; k++) {
+                for (int i = 0; i < numChains; i++) {
+                    double angle = k * 0.1 + i;
+                    Vec3 target(radius * cos(angle), radius * sin(angle), 0.0);
+
+                    chains[i].SetTarget(target);
+                    chains[i].SolveIK();
+
+                    lanes.SetTarget(i, target);
+                }
+
+                lanes.SolveIK();
+
+                for (int i = 0; i < numChains; i++) {
+                    lanes.GetJoints(i, positions);
+
+                    numDifferent += NumDifferent(chains[i].GetPositions(), positions);
+                }
+            }
+
+            passed = ReportDifferences(std::string(orderNames[order]) + ", " + placementNames[placement], numDifferent) && passed;
+        }
+    }
+
+    return passed;
+}
+
+// Poses for many targets solved at once against solving for each target from the same joints, 
+// which must match bitwise, and the joints must be left as they were.  Uses a pool of several 
+// threads and a small grain.  Returns whether they match.
+static bool TargetsCheck() {
+    std::cout << "same-targets: joints different from solving for each target, 4 threads" << std::endl;
+
+    ThreadPool pool(3);
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints = 64;
+    int numTargets = 200;
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int placement = 0; placement < 2; placement++) {
+            QuIK ik;
+            CreateChain(ik, numJoints);
+            ik.SetJointOrderType((QuIK::JointOrderType)order);
+            ik.SetJointPlacementType((QuIK::JointPlacementType)placement);
+            ik.SetTargetJoint(numJoints / 2);
+            ik.SetThreadPool(&pool);
+            ik.SetGrainSize(4);
+
+            std::vector<Vec3> joints = ik.GetPositions();
+
+            double radius = numJoints * 0.5;
+            std::vector<Vec3> targets(numTargets);
+            for (int j = 0; j < numTargets; j++) {
+                targets[j] = Vec3(radius * cos(j * 0.1), radius * sin(j * 0.1), 0.0);
+            }
+
+            std::vector<Vec3> poses;
+            ik.SolveIK(targets, poses);
+
+            int numDifferent = NumDifferent(joints, ik.GetPositions());
+
+            QuIK single = ik;
+            for (int j = 0; j < numTargets; j++) {
+                single.SetJoints(joints);
+                single.SetTargetJoint(numJoints / 2);
+                single.SetTarget(targets[j]);
+                single.SolveIK();
+
+                std::vector<Vec3> pose(poses.begin() + j * numJoints, poses.begin() + (j + 1) * numJoints);
+                numDifferent += NumDifferent(single.GetPositions(), pose);
+            }
+
+            passed = ReportDifferences(std::string(orderNames[order]) + ", " + placementNames[placement], numDifferent) && passed;
+        }
+    }
+
+    return passed;
+}
+
+// Number of joints of StaticQuIK that differ bitwise from QuIK with the same joint order, 
+// placement and priorities, following the same targets from the same chain
+template <int N, QuIK::JointOrderType Order, int... Priorities>
+static int StaticDifferences(QuIK::JointPlacementType placement) {
+    QuIK ik;
+    CreateChain(ik, N);
+    ik.SetJointOrderType(Order);
+    ik.SetJointPlacementType(placement);
+
+    const int priorities[] = { Priorities..., -1 };
+    for (int i = 0; priorities[i] >= 0; i++) {
+        ik.AddPriority(priorities[i]);
+    }
+
+    StaticQuIK<N, Order, Priorities...> ikStatic;
+    std::array<Vec3, N> joints;
+    std::copy(ik.GetPositions().begin(), ik.GetPositions().end(), joints.begin());
+    ikStatic.SetJoints(joints);
+    ikStatic.SetJointPlacementType(placement);
+
+    double radius = (N - 1) * 0.75;
+
+    int numDifferent = 0;
+    for (int i = 0; i < 100; i++) {
+        double angle = i * 0.1;
+        ik.SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+        ik.SolveIK();
+
+        ikStatic.SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+        ikStatic.SolveIK();
+
+        for (int j = 0; j < N; j++) {
+            if (!(ik.GetPositions()[j] == ikStatic.GetPositions()[j])) numDifferent++;
+        }
+    }
+
+    return numDifferent;
+}
+
+// StaticQuIK against QuIK for small chains, which must match bitwise.  Returns whether they do.
+static bool StaticCheck() {
+    std::cout << "same-static: joints different from the dynamic solver" << std::endl;
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+
+    bool passed = true;
+    for (int placement = 0; placement < 2; placement++) {
+        QuIK::JointPlacementType type = (QuIK::JointPlacementType)placement;
+        std::string name = placementNames[placement];
+
+        passed = ReportDifferences(name + ", dividing, 3 joints", StaticDifferences<3, QuIK::DividingJointOrder>(type)) && passed;
+        passed = ReportDifferences(name + ", dividing, 4 joints", StaticDifferences<4, QuIK::DividingJointOrder>(type)) && passed;
+        passed = ReportDifferences(name + ", dividing, 7 joints", StaticDifferences<7, QuIK::DividingJointOrder>(type)) && passed;
+        passed = ReportDifferences(name + ", increasing, 7 joints", StaticDifferences<7, QuIK::IncreasingJointOrder>(type)) && passed;
+        passed = ReportDifferences(name + ", decreasing, 7 joints", StaticDifferences<7, QuIK::DecreasingJointOrder>(type)) && passed;
+        passed = ReportDifferences(name + ", dividing, 7 joints, priority 3", StaticDifferences<7, QuIK::DividingJointOrder, 3>(type)) && passed;
+    }
+
+    return passed;
+}
+
+// Planar chains solved in 2D against the same chains solved in 3D, which must match bitwise 
+// in x and y, with the 3D joints staying at z = 0.  Returns whether they match.
+static bool PlanarCheck() {
+    std::cout << "same-planar: joints different from the 3D solver" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints = 64;
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int placement = 0; placement < 2; placement++) {
+            QuIK ik;
+            CreateChain(ik, numJoints);
+            ik.SetJointOrderType((QuIK::JointOrderType)order);
+            ik.SetJointPlacementType((QuIK::JointPlacementType)placement);
+            ik.AddPriority(numJoints / 3);
+
+            QuIK2D ik2D;
+            CreateChain(ik2D, numJoints);
+            ik2D.SetJointOrderType((QuIK2D::JointOrderType)order);
+            ik2D.SetJointPlacementType((QuIK2D::JointPlacementType)placement);
+            ik2D.AddPriority(numJoints / 3);
+
+            double radius = numJoints * 0.75;
+
+            int numDifferent = 0;
+            for (int k = 0; k < 100; k++) {
+                double angle = k * 0.1;
+                ik.SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+                ik.SolveIK();
+
+                ik2D.SetTarget(Vec2(radius * cos(angle), radius * sin(angle)));
+                ik2D.SolveIK();
+
+                for (int j = 0; j < numJoints; j++) {
+                    const Vec3& p = ik.GetPositions()[j];
+                    const Vec2& q = ik2D.GetPositions()[j];
+
+                    if (!(Vec3(q.x(), q.y(), 0.0) == p)) numDifferent++;
+                }
+            }
+
+            passed = ReportDifferences(std::string(orderNames[order]) + ", " + placementNames[placement], numDifferent) && passed;
+        }
+    }
+
+    return passed;
+}
+
+// Incremental updates against full updates for a target that moves a little at a time, or 
+// is held, with a joint moved now and then, which must match bitwise.  Also fails if nothing 
+// was skipped while the target was held, which would leave the incremental path untested.  
+// Returns whether they match.
+static bool IncrementalCheck() {
+    std::cout << "same-incremental: joints different from a full update" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* placementNames[] = { "triangulation", "inertial" };
+    const char* motionNames[] = { "moving", "held" };
+    int motionSteps[] = { 1, 10 };
+    int numJoints = 256;
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int placement = 0; placement < 2; placement++) {
+            for (int motion = 0; motion < 2; motion++) {
+                QuIK ik[2];
+                for (int j = 0; j < 2; j++) {
+                    CreateChain(ik[j], numJoints);
+                    ik[j].SetJointOrderType((QuIK::JointOrderType)order);
+                    ik[j].SetJointPlacementType((QuIK::JointPlacementType)placement);
+                    ik[j].AddPriority(numJoints / 3);
+                }
+                ik[1].SetUpdateType(QuIK::IncrementalUpdate);
+
+                double radius = numJoints * 0.75;
+
+                int numDifferent = 0;
+                long numSkipped = 0;
+                for (int k = 0; k < 200; k++) {
+                    double angle = (k / motionSteps[motion]) * 0.001;
+                    for (int j = 0; j < 2; j++) {
+                        if (k % 50 == 49) {
+                            ik[j].SetJointPosition(numJoints / 2, ik[j].GetPosition(numJoints / 2) + Vec3(0.0, 0.25, 0.0));
+                        }
+
+                        ik[j].SetTarget(Vec3(radius * cos(angle), radius * sin(angle), 0.0));
+                        ik[j].SolveIK();
+                    }
+
+                    numSkipped += ik[1].GetNumPlacementsSkipped();
+                    numDifferent += NumDifferent(ik[0].GetPositions(), ik[1].GetPositions());
+                }
+
+                std::string name = std::string(orderNames[order]) + ", " + placementNames[placement] + ", " + motionNames[motion];
+                if (motion == 1 && numSkipped == 0) {
+                    std::cout << "  " << name << ": nothing skipped  FAILED" << std::endl;
+                    passed = false;
+                }
+
+                passed = ReportDifferences(name, numDifferent) && passed;
+            }
+        }
+    }
+
+    return passed;
+}
+
+// Lazy updates against full updates in lockstep, which must match bitwise.  After each solve 
+// the end effector and middle joint are requested first, placing just the joints they depend 
+// on, then every joint is requested, so each solve starts from the same joints as the full 
+// update.  Returns whether they match.
+static bool LazyCheck() {
+    std::cout << "same-lazy: joints different from a full update" << std::endl;
+
+    const char* orderNames[] = { "increasing", "decreasing", "dividing" };
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints = 256;
+    int last = numJoints - 1;
+    int middle = last / 2;
+
+    bool passed = true;
+    for (int order = 0; order < 3; order++) {
+        for (int placement = 0; placement < 2; placement++) {
+            // Full and lazy update
+            QuIK ik[2];
+            for (int j = 0; j < 2; j++) {
+                CreateChain(ik[j], numJoints);
+                ik[j].SetJointOrderType((QuIK::JointOrderType)order);
+                ik[j].SetJointPlacementType((QuIK::JointPlacementType)placement);
+                ik[j].AddPriority(numJoints / 3);
+            }
+            ik[1].SetUpdateType(QuIK::LazyUpdate);
+
+            double radius = numJoints * 0.75;
+
+            int numDifferent = 0;
+            for (int k = 0; k < 100; k++) {
+                double angle = k * 0.01;
+                Vec3 target(radius * cos(angle), radius * sin(angle), 0.0);
+
+                for (int j = 0; j < 2; j++) {
+                    ik[j].SetTarget(target);
+                    ik[j].SolveIK();
+                }
+
+                if (!(ik[1].GetPosition(last) == ik[0].GetPositions()[last])) numDifferent++;
+                if (!(ik[1].GetPosition(middle) == ik[0].GetPositions()[middle])) numDifferent++;
+
+                numDifferent += NumDifferent(ik[0].GetPositions(), ik[1].GetPositions());
+            }
+
+            passed = ReportDifferences(std::string(orderNames[order]) + ", " + placementNames[placement], numDifferent) && passed;
+        }
+    }
+
+    return passed;
+}
+
+// Errors of chains solved with another scalar type against doubles, relative to the chain 
+// length, which must be within the given tolerances.  Triangulation varies continuously with 
+// the joints, so its joints are bounded.  Inertial placement picks the closer of two candidate 
+// positions.  When they are nearly equally close, as when the target lands on the old position 
+// of the joint next to it, rounding can pick the other one, so its joints are not bounded, but 
+// its bone lengths and the distance of the end effector from the target are.  Returns whether 
+// the errors are within the tolerances.
+template <class T>
+static bool ScalarCheck(const char* name, double positionTolerance, double lengthTolerance, double effectorTolerance) {
+    std::cout << "error-" << name << ": errors of " << name << " against double, relative to the chain length" << std::endl;
+
+    const char* placementNames[] = { "triangulation", "inertial" };
+    int numJoints[] = { 8, 64, 1024 };
+
+    bool passed = true;
+    for (int placement = 0; placement < 2; placement++) {
+        for (int i = 0; i < 3; i++) {
+            ScalarErrors errors = GetScalarErrors<T>(numJoints[i], (QuIK::JointPlacementType)placement, 200);
+
+            bool within = errors.length <= lengthTolerance && errors.effector <= effectorTolerance &&
+                          (placement == QuIK::InertialJointPlacement || errors.position <= positionTolerance);
+            if (!within) passed = false;
+
+            std::cout << "  " << placementNames[placement] << ", " << numJoints[i] << " joints, position: " 
+                      << errors.position << (placement == QuIK::InertialJointPlacement ? " (not bounded)" : "")
+                      << ", length: " << errors.length 
+                      << ", effector: " << errors.effector 
+                      << (within ? "" : "  FAILED") << std::endl;
+        }
+    }
+
+    std::cout << "  tolerances, position: " << positionTolerance 
+              << ", length: " << lengthTolerance 
+              << ", effector: " << effectorTolerance << std::endl;
+
+    return passed;
+}
+
+
+int main(int argc, char** argv) {
+    std::string name = argc > 1 ? argv[1] : "";
+
+    if (name.empty() || name == "solve") SolveBenchmark();
+    if (name.empty() || name == "edit") EditBenchmark();
+    if (name.empty() || name == "longchain") LongChainBenchmark();
+    if (name.empty() || name == "priorities") PriorityBenchmark();
+    if (name.empty() || name == "parallel") ParallelBenchmark();
+    if (name.empty() || name == "split") SplitBenchmark();
+    if (name.empty() || name == "batch") BatchBenchmark();
+    if (name.empty() || name == "lanes") LanesBenchmark();
+    if (name.empty() || name == "intersection") IntersectionBenchmark();
+    if (name.empty() || name == "targets") TargetsBenchmark();
+    if (name.empty() || name == "float") ScalarBenchmark<float>("float");
+    if (name.empty() || name == "fixed") ScalarBenchmark<Fixed>("fixed");
+    if (name.empty() || name == "static") StaticBenchmark();
+    if (name.empty() || name == "planar") PlanarBenchmark();
+    if (name.empty() || name == "incremental") IncrementalBenchmark();
+    if (name.empty() || name == "lazy") LazyBenchmark();
+
+    // Checks, which fail the run
+    bool passed = true;
+
+    if (name.empty() || name == "alloc") passed = AllocationCheck() && passed;
+    if (name.empty() || name == "reach") passed = ReachCheck() && passed;
+    if (name.empty() || name == "intersect") passed = IntersectionCheck() && passed;
+    if (name.empty() || name == "constraints") passed = ConstraintCheck() && passed;
+    if (name.empty() || name == "same-parallel") passed = ParallelCheck() && passed;
+    if (name.empty() || name == "same-split") passed = SplitCheck() && passed;
+    if (name.empty() || name == "same-batch") passed = BatchCheck() && passed;
+    if (name.empty() || name == "same-lanes") passed = LanesCheck() && passed;
+    if (name.empty() || name == "same-targets") passed = TargetsCheck() && passed;
+    if (name.empty() || name == "same-static") passed = StaticCheck() && passed;
+    if (name.empty() || name == "same-planar") passed = PlanarCheck() && passed;
+    if (name.empty() || name == "same-incremental") passed = IncrementalCheck() && passed;
+    if (name.empty() || name == "same-lazy") passed = LazyCheck() && passed;
+    if (name.empty() || name == "error-float") passed = ScalarCheck<float>("float", 1e-3, 1e-4, 1e-6) && passed;
+    if (name.empty() || name == "error-fixed") passed = ScalarCheck<Fixed>("fixed", 1e-4, 1e-6, 1e-9) && passed;
+
+    return passed ? 0 : 1;
+}
\ No newline at end of file
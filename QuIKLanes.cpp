@@ -0,0 +1,659 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        QuIKLanes.cpp
+//
+// Author:      David Borland
+//
+// Description: Solves the IK for many chains with the same bones at once.  The chains are
+//              packed into blocks of LaneWidth chains, with each coordinate of a joint
+//              stored for every chain in the block together, so every lane of a block
+//              replays the same joint placement plan.  Joints are placed in all lanes
+//              without branching on the type of sphere-sphere intersection in each lane,
+//              so the compiler can use SIMD instructions for the lanes.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "QuIKLanes.h"
+
+#include "ChainReach.h"
+#include "ScalarTraits.h"
+
+#include <math.h>
+
+
+// SSE2 is part of x86-64, so it is used whenever the compiler targets it.  AVX2 is chosen at 
+// runtime, with GCC and Clang on x86.  Each needs whole registers of lanes in a block.
+#if (defined(__SSE2__) || defined(_M_X64)) && QUIK_LANE_WIDTH % 2 == 0
+#define QUIK_HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && QUIK_LANE_WIDTH % 4 == 0
+#define QUIK_DISPATCH_AVX2
+#include <immintrin.h>
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Lane types.  A double in each of Width lanes, converted from a double by setting every 
+// lane, with comparisons giving a mask of the lanes where they hold.
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// One lane at a time, for any processor
+struct ScalarLanes {
+    enum { Width = 1 };
+    typedef bool Mask;
+
+    ScalarLanes() {}
+    ScalarLanes(double a) : v(a) {}
+
+    static ScalarLanes Load(const double* p) { return *p; }
+    void Store(double* p) const { *p = v; }
+
+    double v;
+};
+
+static inline ScalarLanes operator+(const ScalarLanes& a, const ScalarLanes& b) { return a.v + b.v; }
+static inline ScalarLanes operator-(const ScalarLanes& a, const ScalarLanes& b) { return a.v - b.v; }
+static inline ScalarLanes operator*(const ScalarLanes& a, const ScalarLanes& b) { return a.v * b.v; }
+static inline ScalarLanes operator/(const ScalarLanes& a, const ScalarLanes& b) { return a.v / b.v; }
+static inline ScalarLanes operator-(const ScalarLanes& a) { return -a.v; }
+
+static inline bool operator<(const ScalarLanes& a, const ScalarLanes& b) { return a.v < b.v; }
+static inline bool operator<=(const ScalarLanes& a, const ScalarLanes& b) { return a.v <= b.v; }
+static inline bool operator>(const ScalarLanes& a, const ScalarLanes& b) { return a.v > b.v; }
+static inline bool operator>=(const ScalarLanes& a, const ScalarLanes& b) { return a.v >= b.v; }
+static inline bool operator==(const ScalarLanes& a, const ScalarLanes& b) { return a.v == b.v; }
+
+static inline ScalarLanes Sqrt(const ScalarLanes& a) { return sqrt(a.v); }
+static inline ScalarLanes Abs(const ScalarLanes& a) { return fabs(a.v); }
+static inline ScalarLanes Select(bool m, const ScalarLanes& a, const ScalarLanes& b) { return m ? a : b; }
+static inline bool All(bool m) { return m; }
+
+#ifdef QUIK_HAVE_SSE2
+// Two lanes in an SSE2 register
+struct SSE2Mask {
+    explicit SSE2Mask(__m128d a) : m(a) {}
+
+    __m128d m;
+};
+
+struct SSE2Lanes {
+    enum { Width = 2 };
+    typedef SSE2Mask Mask;
+
+    SSE2Lanes() {}
+    SSE2Lanes(double a) : v(_mm_set1_pd(a)) {}
+    explicit SSE2Lanes(__m128d a) : v(a) {}
+
+    static SSE2Lanes Load(const double* p) { return SSE2Lanes(_mm_loadu_pd(p)); }
+    void Store(double* p) const { _mm_storeu_pd(p, v); }
+
+    __m128d v;
+};
+
+static inline SSE2Lanes operator+(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Lanes(_mm_add_pd(a.v, b.v)); }
+static inline SSE2Lanes operator-(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Lanes(_mm_sub_pd(a.v, b.v)); }
+static inline SSE2Lanes operator*(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Lanes(_mm_mul_pd(a.v, b.v)); }
+static inline SSE2Lanes operator/(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Lanes(_mm_div_pd(a.v, b.v)); }
+static inline SSE2Lanes operator-(const SSE2Lanes& a) { return SSE2Lanes(_mm_xor_pd(a.v, _mm_set1_pd(-0.0))); }
+
+static inline SSE2Mask operator<(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Mask(_mm_cmplt_pd(a.v, b.v)); }
+static inline SSE2Mask operator<=(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Mask(_mm_cmple_pd(a.v, b.v)); }
+static inline SSE2Mask operator>(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Mask(_mm_cmpgt_pd(a.v, b.v)); }
+static inline SSE2Mask operator>=(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Mask(_mm_cmpge_pd(a.v, b.v)); }
+static inline SSE2Mask operator==(const SSE2Lanes& a, const SSE2Lanes& b) { return SSE2Mask(_mm_cmpeq_pd(a.v, b.v)); }
+
+static inline SSE2Mask operator&(const SSE2Mask& a, const SSE2Mask& b) { return SSE2Mask(_mm_and_pd(a.m, b.m)); }
+static inline SSE2Mask operator|(const SSE2Mask& a, const SSE2Mask& b) { return SSE2Mask(_mm_or_pd(a.m, b.m)); }
+static inline SSE2Mask operator!(const SSE2Mask& a) { return SSE2Mask(_mm_xor_pd(a.m, _mm_castsi128_pd(_mm_set1_epi32(-1)))); }
+
+static inline SSE2Lanes Sqrt(const SSE2Lanes& a) { return SSE2Lanes(_mm_sqrt_pd(a.v)); }
+static inline SSE2Lanes Abs(const SSE2Lanes& a) { return SSE2Lanes(_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)); }
+static inline SSE2Lanes Select(const SSE2Mask& m, const SSE2Lanes& a, const SSE2Lanes& b) {
+    return SSE2Lanes(_mm_or_pd(_mm_and_pd(m.m, a.v), _mm_andnot_pd(m.m, b.v)));
+}
+static inline bool All(const SSE2Mask& m) { return _mm_movemask_pd(m.m) == 0x3; }
+#endif
+
+#ifdef QUIK_DISPATCH_AVX2
+// Four lanes in an AVX register
+struct AVX2Mask {
+    __attribute__((target("avx2"))) explicit AVX2Mask(__m256d a) : m(a) {}
+
+    __m256d m;
+};
+
+struct AVX2Lanes {
+    enum { Width = 4 };
+    typedef AVX2Mask Mask;
+
+    __attribute__((target("avx2"))) AVX2Lanes() {}
+    __attribute__((target("avx2"))) AVX2Lanes(double a) : v(_mm256_set1_pd(a)) {}
+    __attribute__((target("avx2"))) explicit AVX2Lanes(__m256d a) : v(a) {}
+
+    __attribute__((target("avx2"))) static AVX2Lanes Load(const double* p) { return AVX2Lanes(_mm256_loadu_pd(p)); }
+    __attribute__((target("avx2"))) void Store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    __m256d v;
+};
+
+__attribute__((target("avx2"))) static inline AVX2Lanes operator+(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Lanes(_mm256_add_pd(a.v, b.v)); }
+__attribute__((target("avx2"))) static inline AVX2Lanes operator-(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Lanes(_mm256_sub_pd(a.v, b.v)); }
+__attribute__((target("avx2"))) static inline AVX2Lanes operator*(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Lanes(_mm256_mul_pd(a.v, b.v)); }
+__attribute__((target("avx2"))) static inline AVX2Lanes operator/(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Lanes(_mm256_div_pd(a.v, b.v)); }
+__attribute__((target("avx2"))) static inline AVX2Lanes operator-(const AVX2Lanes& a) { return AVX2Lanes(_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))); }
+
+__attribute__((target("avx2"))) static inline AVX2Mask operator<(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Mask(_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)); }
+__attribute__((target("avx2"))) static inline AVX2Mask operator<=(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Mask(_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)); }
+__attribute__((target("avx2"))) static inline AVX2Mask operator>(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Mask(_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)); }
+__attribute__((target("avx2"))) static inline AVX2Mask operator>=(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Mask(_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)); }
+__attribute__((target("avx2"))) static inline AVX2Mask operator==(const AVX2Lanes& a, const AVX2Lanes& b) { return AVX2Mask(_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)); }
+
+__attribute__((target("avx2"))) static inline AVX2Mask operator&(const AVX2Mask& a, const AVX2Mask& b) { return AVX2Mask(_mm256_and_pd(a.m, b.m)); }
+__attribute__((target("avx2"))) static inline AVX2Mask operator|(const AVX2Mask& a, const AVX2Mask& b) { return AVX2Mask(_mm256_or_pd(a.m, b.m)); }
+__attribute__((target("avx2"))) static inline AVX2Mask operator!(const AVX2Mask& a) { return AVX2Mask(_mm256_xor_pd(a.m, _mm256_castsi256_pd(_mm256_set1_epi32(-1)))); }
+
+__attribute__((target("avx2"))) static inline AVX2Lanes Sqrt(const AVX2Lanes& a) { return AVX2Lanes(_mm256_sqrt_pd(a.v)); }
+__attribute__((target("avx2"))) static inline AVX2Lanes Abs(const AVX2Lanes& a) { return AVX2Lanes(_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)); }
+__attribute__((target("avx2"))) static inline AVX2Lanes Select(const AVX2Mask& m, const AVX2Lanes& a, const AVX2Lanes& b) {
+    return AVX2Lanes(_mm256_blendv_pd(b.v, a.v, m.m));
+}
+__attribute__((target("avx2"))) static inline bool All(const AVX2Mask& m) { return _mm256_movemask_pd(m.m) == 0xF; }
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Lane utilities.  Each computes the same result as the Vec3 and Sphere code used by QuIK
+// for each lane, selecting between cases instead of branching.
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class Lanes>
+struct LanePoint {
+    Lanes x;
+    Lanes y;
+    Lanes z;
+};
+
+template <class Lanes>
+static inline LanePoint<Lanes> MakePoint(const Lanes& x, const Lanes& y, const Lanes& z) {
+    LanePoint<Lanes> p = { x, y, z };
+
+    return p;
+}
+
+// Lanes starting at lane of a joint in a block
+template <class Lanes, class LaneVec3>
+static inline LanePoint<Lanes> LoadPoint(const LaneVec3& v, int lane) {
+    return MakePoint(Lanes::Load(v.x + lane), Lanes::Load(v.y + lane), Lanes::Load(v.z + lane));
+}
+
+template <class Lanes, class LaneVec3>
+static inline void StorePoint(LaneVec3& v, int lane, const LanePoint<Lanes>& p) {
+    p.x.Store(v.x + lane);
+    p.y.Store(v.y + lane);
+    p.z.Store(v.z + lane);
+}
+
+template <class Lanes, class Mask>
+static inline LanePoint<Lanes> Select(const Mask& condition, const LanePoint<Lanes>& a, const LanePoint<Lanes>& b) {
+    return MakePoint(Select(condition, a.x, b.x),
+                     Select(condition, a.y, b.y),
+                     Select(condition, a.z, b.z));
+}
+
+template <class Lanes>
+static inline Lanes DistanceSquared(const LanePoint<Lanes>& a, const LanePoint<Lanes>& b) {
+    Lanes x = a.x - b.x;
+    Lanes y = a.y - b.y;
+    Lanes z = a.z - b.z;
+
+    return x * x + y * y + z * z;
+}
+
+// Is b within, or at least, distance d of a, as Vec3::WithinDistance() and Vec3::BeyondDistance()
+template <class Lanes>
+static inline typename Lanes::Mask WithinDistance(const LanePoint<Lanes>& a, const LanePoint<Lanes>& b, const Lanes& d) {
+    return (d >= 0.0) & (DistanceSquared(a, b) <= d * d);
+}
+
+template <class Lanes>
+static inline typename Lanes::Mask BeyondDistance(const LanePoint<Lanes>& a, const LanePoint<Lanes>& b, const Lanes& d) {
+    return (d <= 0.0) | (DistanceSquared(a, b) >= d * d);
+}
+
+// Closest point on a sphere interior or exterior, as SphereInterior/SphereExterior::ClosestPoint()
+template <class Lanes>
+static inline LanePoint<Lanes> ClosestPoint(const LanePoint<Lanes>& p, const LanePoint<Lanes>& c, const Lanes& r, bool interior) {
+    Lanes x = p.x - c.x;
+    Lanes y = p.y - c.y;
+    Lanes z = p.z - c.z;
+    Lanes d = Sqrt(x * x + y * y + z * z);
+
+    // Normalize, leaving zero vectors alone
+    Lanes scale = 1.0 / d;
+    x = Select(d > 0.0, x * scale, x);
+    y = Select(d > 0.0, y * scale, y);
+    z = Select(d > 0.0, z * scale, z);
+
+    typename Lanes::Mask valid = interior ? WithinDistance(c, p, r) : BeyondDistance(c, p, r);
+
+    return Select(valid, p, MakePoint(c.x + x * r, c.y + y * r, c.z + z * r));
+}
+
+// Is p in the shell around c, within the tolerance, as SphereShell::IsValid()
+template <class Lanes>
+static inline typename Lanes::Mask InShell(const LanePoint<Lanes>& p, const LanePoint<Lanes>& c, const Lanes& rMin, const Lanes& rMax) {
+    const double epsilon = ScalarTraits<double>::Epsilon();
+
+    return WithinDistance(c, p, rMax + epsilon) & BeyondDistance(c, p, rMin - epsilon);
+}
+
+// Closest point in the shell around c, as SphereShell::ClosestPoint()
+template <class Lanes>
+static inline LanePoint<Lanes> ShellClosestPoint(const LanePoint<Lanes>& p, const LanePoint<Lanes>& c, const Lanes& rMin, const Lanes& rMax) {
+    Lanes x = p.x - c.x;
+    Lanes y = p.y - c.y;
+    Lanes z = p.z - c.z;
+    Lanes d2 = x * x + y * y + z * z;
+
+    typename Lanes::Mask insideMax = (rMax >= 0.0) & (d2 <= rMax * rMax);
+    typename Lanes::Mask outsideMin = (rMin <= 0.0) | (d2 >= rMin * rMin);
+
+    // Normalize, leaving zero vectors alone
+    Lanes d = Sqrt(d2);
+    Lanes scale = 1.0 / d;
+    x = Select(d > 0.0, x * scale, x);
+    y = Select(d > 0.0, y * scale, y);
+    z = Select(d > 0.0, z * scale, z);
+
+    // Project onto the violated boundary
+    Lanes r = Select(insideMax, rMin, rMax);
+
+    return Select(insideMax & outsideMin, p, MakePoint(c.x + x * r, c.y + y * r, c.z + z * r));
+}
+
+// Distance and direction from c1 to c2, normalized as Vec3::Normalize() does
+template <class Lanes>
+static inline void Direction(const LanePoint<Lanes>& c1, const LanePoint<Lanes>& c2, Lanes& d, LanePoint<Lanes>& n) {
+    Lanes x = c2.x - c1.x;
+    Lanes y = c2.y - c1.y;
+    Lanes z = c2.z - c1.z;
+    d = Sqrt(x * x + y * y + z * z);
+
+    Lanes scale = 1.0 / d;
+    n = MakePoint(Select(d > 0.0, x * scale, x),
+                  Select(d > 0.0, y * scale, y),
+                  Select(d > 0.0, z * scale, z));
+}
+
+// Point closest to p chosen from the intersection of two spheres, as
+// QuIK::HandleSphereSphereIntersection() with the result of Sphere::Intersection().  Takes the
+// distance d and direction n from c1 to c2, so intersections of the same centers share them.
+template <class Lanes>
+static inline LanePoint<Lanes> IntersectionPoint(const LanePoint<Lanes>& p, const LanePoint<Lanes>& c1, const Lanes& r1, 
+                                                 const LanePoint<Lanes>& c2, const Lanes& r2,
+                                                 const Lanes& d, const LanePoint<Lanes>& n) {
+    Lanes nx = n.x;
+    Lanes ny = n.y;
+    Lanes nz = n.z;
+
+
+    // Concentric spheres, the closest point if the same, otherwise the smallest radius
+    LanePoint<Lanes> same = ClosestPoint(p, c1, r1, true);
+
+    Lanes rMin = Select(r2 < r1, r2, r1);
+    LanePoint<Lanes> concentric = MakePoint(c1.x + nx * rMin, c1.y + ny * rMin, c1.z + nz * rMin);
+
+    // Too far away or touching at a point, on sphere 1 towards sphere 2
+    LanePoint<Lanes> outside = MakePoint(c1.x + nx * r1, c1.y + ny * r1, c1.z + nz * r1);
+
+    // Sphere 2 inside sphere 1, on sphere 2 away from sphere 1
+    LanePoint<Lanes> inside2 = MakePoint(c2.x + nx * r2, c2.y + ny * r2, c2.z + nz * r2);
+
+    // Sphere 1 inside sphere 2, on sphere 1 away from sphere 2
+    LanePoint<Lanes> inside1 = MakePoint(c1.x + -nx * r1, c1.y + -ny * r1, c1.z + -nz * r1);
+
+
+    // Circle, pick the closest of the two possible points
+    Lanes r1_2 = r1 * r1;
+    Lanes r2_2 = r2 * r2;
+    Lanes x = (d * d - r2_2 + r1_2) / (2.0 * d);
+
+    x = Select(Abs(x) > r1, Select(x < 0.0, -r1, r1), x);
+
+    LanePoint<Lanes> c = MakePoint(c1.x + nx * x, c1.y + ny * x, c1.z + nz * x);
+    Lanes r = Sqrt(r1_2 - x * x);
+
+    LanePoint<Lanes> p1 = MakePoint(c.x + -ny * r, c.y + nx * r, c.z + nz * r);
+    LanePoint<Lanes> p2 = MakePoint(c.x + ny * r, c.y + -nx * r, c.z + nz * r);
+
+    LanePoint<Lanes> circle = Select(DistanceSquared(p, p1) < DistanceSquared(p, p2), p1, p2);
+
+
+    // Select the case, in reverse order of the tests in Sphere::Intersection()
+    LanePoint<Lanes> q = circle;
+    q = Select(d == r1 + r2, outside, q);
+    q = Select(d + r1 < r2, inside1, q);
+    q = Select(d + r2 < r1, inside2, q);
+    q = Select(d > r1 + r2, outside, q);
+    q = Select(d <= 0.0, Select(r1 == r2, same, concentric), q);
+
+    return q;
+}
+
+// Keep the closest point to p that satisfies all four radii, as in QuIK::PlaceJointInertial()
+template <class Lanes>
+static inline void ChooseClosest(const LanePoint<Lanes>& p, const LanePoint<Lanes>& q,
+                                 const LanePoint<Lanes>& c1, const Lanes& rMax1, const Lanes& rMin1,
+                                 const LanePoint<Lanes>& c2, const Lanes& rMax2, const Lanes& rMin2,
+                                 LanePoint<Lanes>& closest, Lanes& closestDistance, typename Lanes::Mask& found) {
+    typename Lanes::Mask valid = InShell(q, c1, rMin1, rMax1) & InShell(q, c2, rMin2, rMax2);
+
+    Lanes d = DistanceSquared(p, q);
+
+    typename Lanes::Mask use = valid & ((!found) | (d < closestDistance));
+
+    closest = Select(use, q, closest);
+    closestDistance = Select(use, d, closestDistance);
+    found = found | valid;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+QuIKLanes::QuIKLanes() {
+    numJoints = 0;
+    targetJoint = 0;
+    jointPlacementType = QuIK::TriangulationJointPlacement;
+
+    targetMaxRadius = 0.0;
+    targetMinRadius = 0.0;
+
+    numChains = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set up the chains
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void QuIKLanes::SetChain(QuIK& chain) {
+    numJoints = chain.GetNumJoints();
+    targetJoint = chain.GetTargetJoint();
+    jointPlacementType = chain.GetJointPlacementType();
+
+    // Copy the plan, and the radii used for each placement
+    plan = chain.GetPlan();
+
+    const ChainReach& reach = chain.GetReach();
+
+    radii.resize(plan.GetNumPlacements());
+    for (int i = 0; i < plan.GetNumPlacements(); i++) {
+        const SolvePlan::Placement& p = plan.GetPlacement(i);
+
+        radii[i].max1 = reach.MaxRadius(p.start, p.current);
+        radii[i].min1 = reach.MinRadius(p.start, p.current);
+        radii[i].max2 = reach.MaxRadius(p.end, p.current);
+        radii[i].min2 = reach.MinRadius(p.end, p.current);
+    }
+
+    targetMaxRadius = reach.MaxRadius(0, numJoints - 1);
+    targetMinRadius = reach.MinRadius(0, numJoints - 1);
+
+    initialPositions = chain.GetPositions();
+    initialTarget = chain.GetTarget();
+
+
+    // Restart all chains
+    int n = numChains;
+
+    numChains = 0;
+    positions.clear();
+    targets.clear();
+
+    SetNumChains(n);
+}
+
+int QuIKLanes::GetNumChains() {
+    return numChains;
+}
+
+void QuIKLanes::SetNumChains(int n) {
+    int numBlocks = (n + LaneWidth - 1) / LaneWidth;
+
+    positions.resize(numBlocks * numJoints);
+    targets.resize(numBlocks);
+
+    // Start new chains, including unused lanes, from the initial positions
+    for (int i = numChains; i < numBlocks * LaneWidth; i++) {
+        int block = i / LaneWidth;
+        int lane = i % LaneWidth;
+
+        for (int j = 0; j < numJoints; j++) {
+            SetLane(positions[block * numJoints + j], lane, initialPositions[j]);
+        }
+
+        SetLane(targets[block], lane, initialTarget);
+    }
+
+    numChains = n;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void QuIKLanes::GetJoints(int chain, std::vector<Vec3>& jointPositions) {
+    int block = chain / LaneWidth;
+    int lane = chain % LaneWidth;
+
+    jointPositions.resize(numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        jointPositions[i] = GetLane(positions[block * numJoints + i], lane);
+    }
+}
+
+void QuIKLanes::SetJoints(int chain, const std::vector<Vec3>& jointPositions) {
+    int block = chain / LaneWidth;
+    int lane = chain % LaneWidth;
+
+    for (int i = 0; i < numJoints && i < (int)jointPositions.size(); i++) {
+        SetLane(positions[block * numJoints + i], lane, jointPositions[i]);
+    }
+}
+
+Vec3 QuIKLanes::GetTarget(int chain) {
+    return GetLane(targets[chain / LaneWidth], chain % LaneWidth);
+}
+
+void QuIKLanes::SetTarget(int chain, const Vec3& targetPosition) {
+    SetLane(targets[chain / LaneWidth], chain % LaneWidth, targetPosition);
+}
+
+
+void QuIKLanes::SetLane(LaneVec3& v, int lane, const Vec3& value) {
+    v.x[lane] = value.x();
+    v.y[lane] = value.y();
+    v.z[lane] = value.z();
+}
+
+Vec3 QuIKLanes::GetLane(const LaneVec3& v, int lane) {
+    return Vec3(v.x[lane], v.y[lane], v.z[lane]);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Solve
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void QuIKLanes::SolveIK() {
+    if (numChains == 0 || numJoints == 0) return;
+
+#ifdef QUIK_DISPATCH_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    if (avx2) {
+        SolveBlocksAVX2();
+
+        return;
+    }
+#endif
+
+#ifdef QUIK_HAVE_SSE2
+    SolveBlocks<SSE2Lanes>();
+#else
+    SolveBlocks<ScalarLanes>();
+#endif
+}
+
+#ifdef QUIK_DISPATCH_AVX2
+// Inline everything, so the lane utilities are compiled for AVX2 too
+__attribute__((target("avx2"), flatten))
+void QuIKLanes::SolveBlocksAVX2() {
+    SolveBlocks<AVX2Lanes>();
+}
+#endif
+
+template <class Lanes>
+void QuIKLanes::SolveBlocks() {
+    int numBlocks = targets.size();
+    int numPlacements = plan.GetNumPlacements();
+    const SolvePlan::Placement* placements = plan.GetPlacements();
+
+    // Solve each block completely, so its joints stay in the cache
+    for (int block = 0; block < numBlocks; block++) {
+        LaneVec3* joints = &positions[block * numJoints];
+
+        PlaceTargetJoint<Lanes>(joints, targets[block]);
+
+        switch (jointPlacementType) {
+
+            case QuIK::TriangulationJointPlacement:
+
+                for (int i = 0; i < numPlacements; i++) {
+                    PlaceJointTriangulation<Lanes>(joints, placements[i], radii[i]);
+                }
+
+                break;
+
+            case QuIK::InertialJointPlacement:
+
+                for (int i = 0; i < numPlacements; i++) {
+                    PlaceJointInertial<Lanes>(joints, placements[i], radii[i]);
+                }
+
+                break;
+        }
+    }
+}
+
+template <class Lanes>
+void QuIKLanes::PlaceTargetJoint(LaneVec3* joints, const LaneVec3& target) {
+    if (targetJoint != numJoints - 1) {
+        joints[targetJoint] = target;
+
+        return;
+    }
+
+    // Set the last joint position as close as possible to the target
+    LaneVec3& first = joints[0];
+    LaneVec3& last = joints[numJoints - 1];
+
+    Lanes rMax = targetMaxRadius;
+    Lanes rMin = targetMinRadius;
+
+    for (int i = 0; i < LaneWidth; i += Lanes::Width) {
+        LanePoint<Lanes> c = LoadPoint<Lanes>(first, i);
+        LanePoint<Lanes> p = LoadPoint<Lanes>(last, i);
+        LanePoint<Lanes> t = LoadPoint<Lanes>(target, i);
+
+        LanePoint<Lanes> p1 = ClosestPoint(t, c, rMax, true);
+        LanePoint<Lanes> p2 = ClosestPoint(t, c, rMin, false);
+
+        LanePoint<Lanes> q = Select((DistanceSquared(p, p1) < DistanceSquared(p, p2)) & (Sqrt(DistanceSquared(c, p1)) >= rMin), p1, p2);
+
+        StorePoint(last, i, q);
+    }
+}
+
+template <class Lanes>
+void QuIKLanes::PlaceJointTriangulation(LaneVec3* joints, const SolvePlan::Placement& p, const PlacementRadii& r) {
+    const LaneVec3& start = joints[p.start];
+    const LaneVec3& end = joints[p.end];
+    LaneVec3& current = joints[p.current];
+
+    Lanes rMax1 = r.max1;
+    Lanes rMax2 = r.max2;
+
+    // Lanes are independent, so each group can be written before the next is read
+    for (int i = 0; i < LaneWidth; i += Lanes::Width) {
+        LanePoint<Lanes> c1 = LoadPoint<Lanes>(start, i);
+        LanePoint<Lanes> c2 = LoadPoint<Lanes>(end, i);
+
+        Lanes d;
+        LanePoint<Lanes> n;
+        Direction(c1, c2, d, n);
+
+        StorePoint(current, i, IntersectionPoint(LoadPoint<Lanes>(current, i), c1, rMax1, c2, rMax2, d, n));
+    }
+}
+
+template <class Lanes>
+void QuIKLanes::PlaceJointInertial(LaneVec3* joints, const SolvePlan::Placement& p, const PlacementRadii& r) {
+    const LaneVec3& start = joints[p.start];
+    const LaneVec3& end = joints[p.end];
+    LaneVec3& current = joints[p.current];
+
+    Lanes rMax1 = r.max1;
+    Lanes rMin1 = r.min1;
+    Lanes rMax2 = r.max2;
+    Lanes rMin2 = r.min2;
+
+    for (int i = 0; i < LaneWidth; i += Lanes::Width) {
+        LanePoint<Lanes> q = LoadPoint<Lanes>(current, i);
+        LanePoint<Lanes> c1 = LoadPoint<Lanes>(start, i);
+        LanePoint<Lanes> c2 = LoadPoint<Lanes>(end, i);
+
+        // Leave joints already in a good spot alone
+        typename Lanes::Mask found = InShell(q, c1, rMin1, rMax1) & InShell(q, c2, rMin2, rMax2);
+
+        if (All(found)) continue;
+
+        // Otherwise find the closest legitimate point in each shell
+        LanePoint<Lanes> closest = q;
+        Lanes closestDistance = 0.0;
+
+        ChooseClosest(q, ShellClosestPoint(q, c1, rMin1, rMax1), c1, rMax1, rMin1, c2, rMax2, rMin2, closest, closestDistance, found);
+        ChooseClosest(q, ShellClosestPoint(q, c2, rMin2, rMax2), c1, rMax1, rMin1, c2, rMax2, rMin2, closest, closestDistance, found);
+
+        // Otherwise use the closest legitimate intersection of the spheres, in lanes that need 
+        // it.  If there is none, leave the joint where it is.
+        if (!All(found)) {
+            // Distance and direction between the centers, shared by the intersections.  The 
+            // third intersects from the end joint, with the direction reversed.
+            Lanes d;
+            LanePoint<Lanes> n;
+            Direction(c1, c2, d, n);
+
+            LanePoint<Lanes> reversed = MakePoint(-n.x, -n.y, -n.z);
+
+            LanePoint<Lanes> intersection = q;
+            Lanes intersectionDistance = 0.0;
+            typename Lanes::Mask foundIntersection = intersectionDistance < 0.0;      // None in any lane
+
+            ChooseClosest(q, IntersectionPoint(q, c1, rMax1, c2, rMax2, d, n), c1, rMax1, rMin1, c2, rMax2, rMin2, intersection, intersectionDistance, foundIntersection);
+            ChooseClosest(q, IntersectionPoint(q, c1, rMax1, c2, rMin2, d, n), c1, rMax1, rMin1, c2, rMax2, rMin2, intersection, intersectionDistance, foundIntersection);
+            ChooseClosest(q, IntersectionPoint(q, c2, rMax2, c1, rMin1, d, reversed), c1, rMax1, rMin1, c2, rMax2, rMin2, intersection, intersectionDistance, foundIntersection);
+            ChooseClosest(q, IntersectionPoint(q, c1, rMin1, c2, rMin2, d, n), c1, rMax1, rMin1, c2, rMax2, rMin2, intersection, intersectionDistance, foundIntersection);
+
+            closest = Select(found, closest, intersection);
+        }
+
+        StorePoint(current, i, closest);
+    }
+}
\ No newline at end of file
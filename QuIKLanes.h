@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        QuIKLanes.h
+//
+// Author:      David Borland
+//
+// Description: Solves the IK for many chains with the same bones at once.  The chains are
+//              packed into blocks of LaneWidth chains, with each coordinate of a joint
+//              stored for every chain in the block together, so every lane of a block
+//              replays the same joint placement plan.  Joints are placed in all lanes
+//              without branching on the type of sphere-sphere intersection in each lane,
+//              using SIMD instructions for the lanes.  On x86 the lanes are placed with
+//              AVX2 if the processor has it, chosen at runtime, and with SSE2 otherwise.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef QUIKLANES_H
+#define QUIKLANES_H
+
+
+#include "QuIK.h"
+#include "SolvePlan.h"
+#include "Vec3.h"
+
+#include <vector>
+
+
+// Number of lanes per block, set by the instruction set.  On x86 a block fills an AVX register,
+// or two SSE2 registers when the processor does not have AVX2.  Define as 1 for the scalar 
+// fallback.
+#ifndef QUIK_LANE_WIDTH
+#if defined(__AVX512F__)
+#define QUIK_LANE_WIDTH 8
+#elif defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#define QUIK_LANE_WIDTH 4
+#elif defined(__ARM_NEON)
+#define QUIK_LANE_WIDTH 2
+#else
+#define QUIK_LANE_WIDTH 1
+#endif
+#endif
+
+
+class QuIKLanes {
+public:
+    // Constructor
+    QuIKLanes();
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Chains per block
+    enum { LaneWidth = QUIK_LANE_WIDTH };
+
+
+    // Copy the bones, joint order, joint placement, priorities and target joint from a
+    // chain.  Chains start at the joint positions and target of this chain.
+    void SetChain(QuIK& chain);
+
+    // Number of chains
+    int GetNumChains();
+    void SetNumChains(int n);
+
+    // Get/set joint positions and target of one chain
+    void GetJoints(int chain, std::vector<Vec3>& jointPositions);
+    void SetJoints(int chain, const std::vector<Vec3>& jointPositions);
+    Vec3 GetTarget(int chain);
+    void SetTarget(int chain, const Vec3& targetPosition);
+
+    // Solve all chains
+    void SolveIK();
+
+protected:
+    // One joint or target in every lane of a block
+    struct LaneVec3 {
+        double x[LaneWidth];
+        double y[LaneWidth];
+        double z[LaneWidth];
+    };
+
+    // Radii for one placement, the same in every lane
+    struct PlacementRadii {
+        double max1;
+        double min1;
+        double max2;
+        double min2;
+    };
+
+    // Solve every block with the given lane type, or with AVX2
+    template <class Lanes>
+    void SolveBlocks();
+    void SolveBlocksAVX2();
+
+    // Place joints in every lane of a block, Lanes::Width lanes at a time
+    template <class Lanes>
+    void PlaceTargetJoint(LaneVec3* joints, const LaneVec3& target);
+    template <class Lanes>
+    void PlaceJointTriangulation(LaneVec3* joints, const SolvePlan::Placement& p, const PlacementRadii& r);
+    template <class Lanes>
+    void PlaceJointInertial(LaneVec3* joints, const SolvePlan::Placement& p, const PlacementRadii& r);
+
+    // Copy to and from a lane
+    static void SetLane(LaneVec3& v, int lane, const Vec3& value);
+    static Vec3 GetLane(const LaneVec3& v, int lane);
+
+
+    // Chain description
+    int numJoints;
+    int targetJoint;
+    QuIK::JointPlacementType jointPlacementType;
+
+    SolvePlan plan;
+    std::vector<PlacementRadii> radii;
+
+    // Radii for placing the target joint at the end of the chain
+    double targetMaxRadius;
+    double targetMinRadius;
+
+    // Starting joint positions and target
+    std::vector<Vec3> initialPositions;
+    Vec3 initialTarget;
+
+    // Joint positions, numJoints per block, and target for each block
+    int numChains;
+    std::vector<LaneVec3> positions;
+    std::vector<LaneVec3> targets;
+};
+
+
+#endif
\ No newline at end of file
@@ -925,8 +925,7 @@ void qvGLWidget::RenderOverlap() {
 
     std::vector<Vec3> positions = ik->GetPositions();
     
-    std::vector<std::vector<double>> maxRadii = ik->GetMaxRadii();
-    std::vector<std::vector<double>> minRadii = ik->GetMinRadii();
+    const ChainReach& reach = ik->GetReach();
     
 
     // Set up for rendering overlapping regions
@@ -1029,8 +1028,8 @@ std::cout << std::endl;
 
         // Draw overlap
         DrawOverlap(c1, c2, 
-                    maxRadii[startOrder[i]][currentOrder[i]], minRadii[startOrder[i]][currentOrder[i]],
-                    maxRadii[endOrder[i]][currentOrder[i]], minRadii[endOrder[i]][currentOrder[i]]);
+                    reach.MaxRadius(startOrder[i], currentOrder[i]), reach.MinRadius(startOrder[i], currentOrder[i]),
+                    reach.MaxRadius(endOrder[i], currentOrder[i]), reach.MinRadius(endOrder[i], currentOrder[i]));
     }
 
 // This draws a circle for the last joint
@@ -1038,7 +1037,7 @@ std::cout << std::endl;
         glColor3f(0.0, 0.0, 0.0);
     int s = positions.size() - 1;
         DrawOverlap(positions[0], positions[0], 
-                    maxRadii[0][s], maxRadii[0][s],
+                    reach.MaxRadius(0, s), reach.MaxRadius(0, s),
                     0.0, 0.0);
 */
 
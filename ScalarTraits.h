@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ScalarTraits.h
+//
+// Author:      David Borland
+//
+// Description: Constants that depend on the scalar type the geometry and solver are
+//              instantiated with.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SCALARTRAITS_H
+#define SCALARTRAITS_H
+
+
+#include "Fixed.h"
+
+
+template <class T>
+struct ScalarTraits;
+
+
+template <>
+struct ScalarTraits<double> {
+    // Tolerance for a point to count as on or within a sphere
+    static double Epsilon() { return 1e-10; }
+
+    // Type to sum many values in
+    typedef double Sum;
+};
+
+template <>
+struct ScalarTraits<float> {
+    // Above the rounding of coordinates up to about 1000, so chains should span less than that
+    static float Epsilon() { return 1e-4f; }
+
+    // Wider, so differences of long sums keep the precision of a float
+    typedef double Sum;
+};
+
+template <>
+struct ScalarTraits<Fixed> {
+    // About 4000 ulps, above the rounding of the products in a sphere intersection
+    static Fixed Epsilon() { return Fixed(1e-6); }
+
+    // Fixed point sums are exact
+    typedef Fixed Sum;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SolvePlan.cpp
+//
+// Author:      David Borland
+//
+// Description: The order of joint placement for solving the IK, as a flat list of 
+//              placements.  Depends only on the chain length, joint order, priorities and 
+//              target joint, so it can be compiled once and replayed for every solve.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#include "SolvePlan.h"
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+SolvePlan::SolvePlan() {
+    _numRoots = 0;
+    _valid = false;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Compile the plan
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void SolvePlan::Clear() {
+    _placements.clear();
+    _numRoots = 0;
+    _valid = false;
+}
+
+void SolvePlan::Reserve(int numPlacements) {
+    _placements.reserve(numPlacements);
+}
+
+void SolvePlan::Add(int start, int current, int end) {
+    Placement placement;
+    placement.start = start;
+    placement.current = current;
+    placement.end = end;
+    placement.size = 1;
+    placement.writesStart = false;
+    placement.writesEnd = false;
+
+    _placements.push_back(placement);
+}
+
+void SolvePlan::Finish() {
+    // Work backwards so that subdivisions are done first
+    _numRoots = 0;
+    for (int i = (int)_placements.size() - 1; i >= 0; i--) {
+        Placement& p = _placements[i];
+
+        p.writesStart = p.current == p.start;
+        p.writesEnd = p.current == p.end;
+
+        if (p.end - p.start > 2) {
+            // Subdivided, first half follows this placement and second half follows that
+            const Placement& first = _placements[i + 1];
+            const Placement& second = _placements[i + 1 + first.size];
+
+            p.size = 1 + first.size + second.size;
+            p.writesStart = p.writesStart || first.writesStart;
+            p.writesEnd = p.writesEnd || second.writesEnd;
+        }
+        else {
+            p.size = 1;
+        }
+    }
+
+    // Count the intervals compiled, which follow each other
+    for (int i = 0; i < (int)_placements.size(); i += _placements[i].size) {
+        _numRoots++;
+    }
+
+    _valid = true;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Validity
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void SolvePlan::Invalidate() {
+    _valid = false;
+}
+
+bool SolvePlan::IsValid() const {
+    return _valid;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+int SolvePlan::GetNumPlacements() const {
+    return _placements.size();
+}
+
+int SolvePlan::GetNumRoots() const {
+    return _numRoots;
+}
+
+const SolvePlan::Placement& SolvePlan::GetPlacement(int i) const {
+    return _placements[i];
+}
+
+const SolvePlan::Placement* SolvePlan::GetPlacements() const {
+    return _placements.data();
+}
\ No newline at end of file
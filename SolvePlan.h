@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SolvePlan.h
+//
+// Author:      David Borland
+//
+// Description: The order of joint placement for solving the IK, as a flat list of 
+//              placements.  Depends only on the chain length, joint order, priorities and 
+//              target joint, so it can be compiled once and replayed for every solve.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#ifndef SOLVEPLAN_H
+#define SOLVEPLAN_H
+
+
+#include <vector>
+
+
+class SolvePlan {
+public:
+    // Constructor
+    SolvePlan();                                    // Empty and invalid
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Place the current joint using the start and end joints.  Placements are stored in 
+    // the order they are made, so the placements that subdivide this one follow it.
+    struct Placement {
+        int start;
+        int current;
+        int end;
+
+        // Number of placements made for this interval, including this one
+        int size;
+
+        // Whether any placement for this interval moves the start or end joint
+        bool writesStart;
+        bool writesEnd;
+    };
+
+
+    // Compile the plan
+    void Clear();                                   // Remove all placements and invalidate
+    void Reserve(int numPlacements);
+    void Add(int start, int current, int end);
+    void Finish();                                  // Set sizes and mark as valid
+
+
+    // Mark as needing to be compiled again
+    void Invalidate();
+    bool IsValid() const;
+
+
+    // Element access
+    int GetNumPlacements() const;
+    int GetNumRoots() const;                        // Number of intervals compiled
+    const Placement& GetPlacement(int i) const;
+    const Placement* GetPlacements() const;
+
+protected:
+    std::vector<Placement> _placements;
+
+    int _numRoots;
+
+    bool _valid;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SolveWorkspace.cpp
+//
+// Author:      David Borland
+//
+// Description: Scratch space used while solving the IK.  Sized for the chain up front and 
+//              reused, so solving does not allocate once the workspace has warmed up.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#include "SolveWorkspace.h"
+
+#include "Fixed.h"
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+SolveWorkspaceT<T, D>::SolveWorkspaceT() {
+    numPlaced = 0;
+    numSkipped = 0;
+
+    numMoves = 1;
+    firstMove = 1;
+
+    lazyPending = false;
+    numLazySolutions = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Capacity
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+void SolveWorkspaceT<T, D>::Reserve(int numJoints, int numPriorities) {
+    // Each interval places a joint strictly inside it and splits in two, so there are fewer 
+    // than numJoints subdivided intervals, and at most one more leaf interval than that
+    int maxPlacements = 2 * numJoints;
+
+    intervals.reserve(numJoints);
+    priorities.Reserve(numJoints, numPriorities);
+
+    startOrder.reserve(maxPlacements);
+    currentOrder.reserve(maxPlacements);
+    endOrder.reserve(maxPlacements);
+
+    if ((int)deferred.size() < maxPlacements) {
+        deferredPositions.resize(maxPlacements);
+        deferred.resize(maxPlacements);
+    }
+
+    if ((int)jointMoves.size() < numJoints) {
+        jointMoves.resize(numJoints, 0);
+    }
+
+    if ((int)settled.size() < maxPlacements) {
+        settled.resize(maxPlacements, 0);
+        lazyPlaced.resize(maxPlacements, 0);
+        lazyIntervals.resize(maxPlacements, 0);
+    }
+
+    open.reserve(numJoints);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Joint moves
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+void SolveWorkspaceT<T, D>::MoveJoint(int jointIndex) {
+    jointMoves[jointIndex] = ++numMoves;
+}
+
+template <class T, int D>
+void SolveWorkspaceT<T, D>::ForgetMoves() {
+    // Settled counts are at most the current count, so are all before the new first move
+    firstMove = ++numMoves;
+}
+
+
+template class SolveWorkspaceT<float, 2>;
+template class SolveWorkspaceT<double, 2>;
+template class SolveWorkspaceT<Fixed, 2>;
+template class SolveWorkspaceT<float, 3>;
+template class SolveWorkspaceT<double, 3>;
+template class SolveWorkspaceT<Fixed, 3>;
\ No newline at end of file
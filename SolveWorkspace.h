@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SolveWorkspace.h
+//
+// Author:      David Borland
+//
+// Description: Scratch space used while solving the IK.  Sized for the chain up front and 
+//              reused, so solving does not allocate once the workspace has warmed up.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#ifndef SOLVEWORKSPACE_H
+#define SOLVEWORKSPACE_H
+
+
+#include "PriorityIndex.h"
+#include "VecN.h"
+
+#include <vector>
+
+
+template <class T, int D = 3>
+class SolveWorkspaceT {
+public:
+    // Constructor
+    SolveWorkspaceT();
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Make room for solving a chain.  Only grows, never shrinks.
+    void Reserve(int numJoints, int numPriorities);
+
+
+    // Intervals still to be solved
+    struct Interval {
+        Interval(int s, int e) : start(s), end(e) {}
+
+        int start;
+        int end;
+    };
+    std::vector<Interval> intervals;
+
+    // Priorities not yet placed
+    PriorityIndex priorities;
+
+    // Joint positions held back during parallel execution, one per placement
+    std::vector<VecT<T, D> > deferredPositions;
+    std::vector<char> deferred;
+
+    // Order of joint placement
+    std::vector<int> startOrder;
+    std::vector<int> currentOrder;
+    std::vector<int> endOrder;
+
+    // Joint placements made and skipped during the most recent solution
+    int numPlaced;
+    int numSkipped;
+
+
+    // Joint moves for incremental updates, counted over all solutions.  The count when each 
+    // joint last moved, and when each placement's interval was last solved without moving a 
+    // joint.  Counts before firstMove are forgotten.
+    unsigned long long numMoves;
+    unsigned long long firstMove;
+    std::vector<unsigned long long> jointMoves;
+    std::vector<unsigned long long> settled;
+
+    void MoveJoint(int jointIndex);
+    void ForgetMoves();                             // Solve every interval next time
+
+    // Placements whose intervals are being solved by an incremental update
+    struct OpenPlacement {
+        OpenPlacement(int p, int e, unsigned long long m) : placement(p), end(e), moves(m) {}
+
+        int placement;
+        int end;                                    // Index of the placement after the interval
+        unsigned long long moves;                   // Count when the interval was started
+    };
+    std::vector<OpenPlacement> open;
+
+
+    // Lazy updates, counted over all solutions.  Whether placements of the most recent lazy 
+    // solution are still to be made, and the solution each placement, and each placement's 
+    // whole interval, was last made for.
+    bool lazyPending;
+    unsigned long long numLazySolutions;
+    std::vector<unsigned long long> lazyPlaced;
+    std::vector<unsigned long long> lazyIntervals;
+};
+
+
+typedef SolveWorkspaceT<double> SolveWorkspace;
+
+
+#endif
\ No newline at end of file
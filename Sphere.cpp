@@ -4,131 +4,109 @@
 //
 // Author:      David Borland
 //
-// Description: Sphere class.
+// Description: Sphere class, a circle in 2D.
 //
 /////////////////////////////////////////////////////////////////////////////////////////////// 
 
 
 #include "Sphere.h"
 
-#include <math.h>
+#include <cmath>
 
+#include <algorithm>
 
-const double Sphere::epsilon = 1e-10;
 
+// SSE2 is part of x86-64, so it is used whenever the compiler targets it.  AVX2 is chosen at 
+// runtime, with GCC and Clang on x86.
+#if defined(__SSE2__) || defined(_M_X64)
+#define QUIK_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
-///////////////////////////////////////////////////////////////////////////////////////////////
-// Constructors
-///////////////////////////////////////////////////////////////////////////////////////////////
-
-Sphere::Sphere() {
-    MakeIdentity();
-}
-
-Sphere::Sphere(const Vec3& c, double r) {
-    Set(c, r);
-}
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define QUIK_DISPATCH_AVX2
+#include <immintrin.h>
+#endif
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
-// Destructor
-///////////////////////////////////////////////////////////////////////////////////////////////
-
-Sphere::~Sphere() {
-}
-
-
-///////////////////////////////////////////////////////////////////////////////////////////////
-// Set values
+// Utilities
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-void Sphere::MakeIdentity() {
-    Set(Vec3(0.0, 0.0, 0.0), 1.0);
-}
-
-void Sphere::Set(const Vec3& c, double r) {
-    _c = c;
-    _r = r;
-}
-
-
-///////////////////////////////////////////////////////////////////////////////////////////////
-// Element access
-///////////////////////////////////////////////////////////////////////////////////////////////
+template <class T, int D>
+typename SphereT<T, D>::SSI_Type SphereT<T, D>::Intersection(const SphereT& s, Vec& c, T& r, Vec& n) const {
+    SSI_Type type;
 
-Vec3& Sphere::c() {
-    return _c;
-}
+    Intersection(_c, s._c, 1, &_r, &s._r, &type, &c, &r, &n);
 
-double& Sphere::r() {
-    return _r;
+    return type;
 }
 
+template <class T, int D>
+void SphereT<T, D>::Intersection(const Vec& c1, const Vec& c2, int numPairs, const T* r1, const T* r2,
+                              SSI_Type* type, Vec* c, T* r, Vec* n) {
+    // Calculate the direction and distance between the two centers
+    Vec n12 = c2 - c1;
+    T d = n12.Magnitude();
+    n12.Normalize();
 
-Vec3 Sphere::c() const {
-    return _c;
-}
-
-double Sphere::r() const {
-    return _r;
+    for (int i = 0; i < numPairs; i++) {
+        type[i] = Intersection(c1, r1[i], c2, r2[i], d, n12, c[i], r[i], n[i]);
+    }
 }
 
+template <class T, int D>
+typename SphereT<T, D>::SSI_Type SphereT<T, D>::Intersection(const Vec& c1, T r1, const Vec& c2, T r2, T d, const Vec& n12,
+                                                       Vec& c, T& r, Vec& n) {
+    using std::fabs;
+    using std::sqrt;
 
-///////////////////////////////////////////////////////////////////////////////////////////////
-// Utilities
-///////////////////////////////////////////////////////////////////////////////////////////////
-
-Sphere::SSI_Type Sphere::Intersection(const Sphere& s, Vec3& c, double& r, Vec3& n) const {
-    // Calculate the direction and distance between the two centers
-    n = s._c - _c;
-    double d = n.Magnitude();
-    n.Normalize();
+    n = n12;
 
     // Check for intersection
-    if (d <= 0.0) {
+    if (d <= T(0)) {
         // Concentric spheres
-        if (_r == r) {
+        if (r1 == r2) {
             // Same sphere
-            c = _c;
-            r = _r;
+            c = c1;
+            r = r1;
 
             return SSI_Sphere;
         }
         else {
             // No intersection, return the smallest radius
-            c = _c;
-            r = std::min(_r, s._r);
+            c = c1;
+            r = std::min(r1, r2);
 
             return SSI_EmptyInside;
         }
     }
-    else if (d > _r + s._r) {
+    else if (d > r1 + r2) {
         // Too far away, no intersection
-        c = _c;
-        r = _r;
+        c = c1;
+        r = r1;
 
         return SSI_EmptyOutside;
     }
-    else if (d + s._r < _r) {
+    else if (d + r2 < r1) {
         // Sphere 2 completely inside sphere 1
-        c = s._c;
-        r = s._r;
+        c = c2;
+        r = r2;
 
         return SSI_EmptyInside;
     }
-    else if (d + _r < s._r) {
+    else if (d + r1 < r2) {
         // Sphere 1 completely inside sphere 2
-        c = _c;
-        r = _r;
-        n = _c - s._c;
-        n.Normalize();
+        c = c1;
+        r = r1;
+        n = !n12;
 
         return SSI_EmptyInside;
     }
-    else if (d == _r + s._r) {
+    else if (d == r1 + r2) {
         // Intersection is a point
-        c = _c + n * _r;
-        r = 0.0;
+        c = c1 + n * r1;
+        r = T(0);
 
         return SSI_Point;
     }
@@ -138,19 +116,19 @@ Sphere::SSI_Type Sphere::Intersection(const Sphere& s, Vec3& c, double& r, Vec3&
 	// For now, assume the first sphere is at the origin and
 	// the second is at a distance of d along the x-axis, and
 	// solve for the location of the intersection plane.
-    double r1_2 = _r * _r;
-    double r2_2 = s._r * s._r;
-	double x = (d * d - r2_2 + r1_2) / (2.0 * d);
+    T r1_2 = r1 * r1;
+    T r2_2 = r2 * r2;
+	T x = (d * d - r2_2 + r1_2) / (T(2) * d);
 
 
-	if (fabs(x) > _r) {
-        // Must be a floating point precision problem, set to length of _r
-        x = x < 0.0 ? -_r : _r;
+	if (fabs(x) > r1) {
+        // Must be a floating point precision problem, set to length of r1
+        x = x < T(0) ? -r1 : r1;
 	}
 
 
 	// Calculate the circle center, given the distance from sphere 1
-    c = _c + n * x;
+    c = c1 + n * x;
 
 	// Compute the radius
 	r = sqrt(r1_2 - x * x);
@@ -158,24 +136,386 @@ Sphere::SSI_Type Sphere::Intersection(const Sphere& s, Vec3& c, double& r, Vec3&
 	return SSI_Circle;
 }
 
-Vec3 Sphere::ClosestPoint(const Vec3& p) const {
-    Vec3 v = p - _c;
-    v.Normalize();
+// A component of the direction between the centers, scaled as the vector Normalize() does for 
+// the scalar type
+template <class T>
+static inline T Normalized(T v, T d) {
+    return v * (T(1) / d);
+}
+
+static inline Fixed Normalized(Fixed v, Fixed d) {
+    return v / d;
+}
+
+// The same steps as the single intersection, with every case computed and the result chosen 
+// by selects, applying the cases from last to first so the first that holds is kept.  Used 
+// when there is no SIMD version, and for the pairs left over after the SIMD blocks.
+template <class T, int D>
+static void IntersectionRange(int first, int last, 
+                              const typename SphereT<T, D>::SphereArrays& s1, const typename SphereT<T, D>::SphereArrays& s2, 
+                              const typename SphereT<T, D>::IntersectionArrays& result) {
+    typedef SphereT<T, D> Sphere;
+    using std::fabs;
+    using std::sqrt;
+
+    for (int i = first; i < last; i++) {
+        // The z components are 0 in 2D
+        T x1 = s1.x[i];
+        T y1 = s1.y[i];
+        T z1 = D == 3 ? s1.z[i] : T(0);
+        T r1 = s1.r[i];
+
+        T x2 = s2.x[i];
+        T y2 = s2.y[i];
+        T z2 = D == 3 ? s2.z[i] : T(0);
+        T r2 = s2.r[i];
+
+        // Direction and distance between the centers, normalized as the vector Normalize() does
+        T nx = x2 - x1;
+        T ny = y2 - y1;
+        T nz = z2 - z1;
+        T d = sqrt(nx * nx + ny * ny + nz * nz);
+
+        bool concentric = d <= T(0);
+        nx = concentric ? nx : Normalized(nx, d);
+        ny = concentric ? ny : Normalized(ny, d);
+        nz = concentric ? nz : Normalized(nz, d);
+
+        // The circle, clamped as in the single intersection
+        T r1_2 = r1 * r1;
+        T r2_2 = r2 * r2;
+        T x = (d * d - r2_2 + r1_2) / (T(2) * d);
+        T clamped = x < T(0) ? -r1 : r1;
+        x = fabs(x) > r1 ? clamped : x;
+
+        int type = Sphere::SSI_Circle;
+        T cx = x1 + nx * x;
+        T cy = y1 + ny * x;
+        T cz = z1 + nz * x;
+        T r = sqrt(r1_2 - x * x);
+        T sign = T(1);
+
+        bool point = d == r1 + r2;
+        type = point ? Sphere::SSI_Point : type;
+        cx = point ? x1 + nx * r1 : cx;
+        cy = point ? y1 + ny * r1 : cy;
+        cz = point ? z1 + nz * r1 : cz;
+        r = point ? T(0) : r;
+
+        bool inside2 = d + r1 < r2;
+        type = inside2 ? Sphere::SSI_EmptyInside : type;
+        cx = inside2 ? x1 : cx;
+        cy = inside2 ? y1 : cy;
+        cz = inside2 ? z1 : cz;
+        r = inside2 ? r1 : r;
+        sign = inside2 ? T(-1) : sign;
+
+        bool inside1 = d + r2 < r1;
+        type = inside1 ? Sphere::SSI_EmptyInside : type;
+        cx = inside1 ? x2 : cx;
+        cy = inside1 ? y2 : cy;
+        cz = inside1 ? z2 : cz;
+        r = inside1 ? r2 : r;
+        sign = inside1 ? T(1) : sign;
+
+        bool outside = d > r1 + r2;
+        type = outside ? Sphere::SSI_EmptyOutside : type;
+        cx = outside ? x1 : cx;
+        cy = outside ? y1 : cy;
+        cz = outside ? z1 : cz;
+        r = outside ? r1 : r;
+        sign = outside ? T(1) : sign;
+
+        bool same = r1 == r2;
+        type = concentric ? (same ? Sphere::SSI_Sphere : Sphere::SSI_EmptyInside) : type;
+        cx = concentric ? x1 : cx;
+        cy = concentric ? y1 : cy;
+        cz = concentric ? z1 : cz;
+        r = concentric ? (same ? r1 : std::min(r1, r2)) : r;
+        sign = concentric ? T(1) : sign;
+
+        result.type[i] = (typename Sphere::SSI_Type)type;
+        result.cx[i] = cx;
+        result.cy[i] = cy;
+        result.r[i] = r;
+        result.nx[i] = sign * nx;
+        result.ny[i] = sign * ny;
+
+        if (D == 3) {
+            result.cz[i] = cz;
+            result.nz[i] = sign * nz;
+        }
+    }
+}
+
+#ifdef QUIK_HAVE_SSE2
+// Select b where the mask is set, otherwise a
+static inline __m128d Select(__m128d a, __m128d b, __m128d mask) {
+    return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+}
+
+// IntersectionRange for two pairs at a time
+static void IntersectionSSE2(int n, const Sphere::SphereArrays& s1, const Sphere::SphereArrays& s2, 
+                             const Sphere::IntersectionArrays& result) {
+    const int width = 2;
+    int last = n - n % width;
+
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d two = _mm_set1_pd(2.0);
+    const __m128d negativeZero = _mm_set1_pd(-0.0);
+
+    for (int i = 0; i < last; i += width) {
+        __m128d x1 = _mm_loadu_pd(s1.x + i);
+        __m128d y1 = _mm_loadu_pd(s1.y + i);
+        __m128d z1 = _mm_loadu_pd(s1.z + i);
+        __m128d r1 = _mm_loadu_pd(s1.r + i);
+
+        __m128d x2 = _mm_loadu_pd(s2.x + i);
+        __m128d y2 = _mm_loadu_pd(s2.y + i);
+        __m128d z2 = _mm_loadu_pd(s2.z + i);
+        __m128d r2 = _mm_loadu_pd(s2.r + i);
+
+        __m128d nx = _mm_sub_pd(x2, x1);
+        __m128d ny = _mm_sub_pd(y2, y1);
+        __m128d nz = _mm_sub_pd(z2, z1);
+        __m128d d = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, nx), _mm_mul_pd(ny, ny)), _mm_mul_pd(nz, nz)));
+
+        __m128d scale = _mm_div_pd(one, d);
+        __m128d concentric = _mm_cmple_pd(d, zero);
+        nx = Select(_mm_mul_pd(nx, scale), nx, concentric);
+        ny = Select(_mm_mul_pd(ny, scale), ny, concentric);
+        nz = Select(_mm_mul_pd(nz, scale), nz, concentric);
+
+        __m128d r1_2 = _mm_mul_pd(r1, r1);
+        __m128d r2_2 = _mm_mul_pd(r2, r2);
+        __m128d x = _mm_div_pd(_mm_add_pd(_mm_sub_pd(_mm_mul_pd(d, d), r2_2), r1_2), _mm_mul_pd(two, d));
+        __m128d clamped = Select(r1, _mm_xor_pd(r1, negativeZero), _mm_cmplt_pd(x, zero));
+        x = Select(x, clamped, _mm_cmpgt_pd(_mm_andnot_pd(negativeZero, x), r1));
+
+        __m128d type = _mm_set1_pd(Sphere::SSI_Circle);
+        __m128d cx = _mm_add_pd(x1, _mm_mul_pd(nx, x));
+        __m128d cy = _mm_add_pd(y1, _mm_mul_pd(ny, x));
+        __m128d cz = _mm_add_pd(z1, _mm_mul_pd(nz, x));
+        __m128d r = _mm_sqrt_pd(_mm_sub_pd(r1_2, _mm_mul_pd(x, x)));
+        __m128d sign = one;
+
+        __m128d point = _mm_cmpeq_pd(d, _mm_add_pd(r1, r2));
+        type = Select(type, _mm_set1_pd(Sphere::SSI_Point), point);
+        cx = Select(cx, _mm_add_pd(x1, _mm_mul_pd(nx, r1)), point);
+        cy = Select(cy, _mm_add_pd(y1, _mm_mul_pd(ny, r1)), point);
+        cz = Select(cz, _mm_add_pd(z1, _mm_mul_pd(nz, r1)), point);
+        r = Select(r, zero, point);
+
+        __m128d inside2 = _mm_cmplt_pd(_mm_add_pd(d, r1), r2);
+        type = Select(type, _mm_set1_pd(Sphere::SSI_EmptyInside), inside2);
+        cx = Select(cx, x1, inside2);
+        cy = Select(cy, y1, inside2);
+        cz = Select(cz, z1, inside2);
+        r = Select(r, r1, inside2);
+        sign = Select(sign, _mm_set1_pd(-1.0), inside2);
+
+        __m128d inside1 = _mm_cmplt_pd(_mm_add_pd(d, r2), r1);
+        type = Select(type, _mm_set1_pd(Sphere::SSI_EmptyInside), inside1);
+        cx = Select(cx, x2, inside1);
+        cy = Select(cy, y2, inside1);
+        cz = Select(cz, z2, inside1);
+        r = Select(r, r2, inside1);
+        sign = Select(sign, one, inside1);
+
+        __m128d outside = _mm_cmpgt_pd(d, _mm_add_pd(r1, r2));
+        type = Select(type, _mm_set1_pd(Sphere::SSI_EmptyOutside), outside);
+        cx = Select(cx, x1, outside);
+        cy = Select(cy, y1, outside);
+        cz = Select(cz, z1, outside);
+        r = Select(r, r1, outside);
+        sign = Select(sign, one, outside);
+
+        __m128d same = _mm_cmpeq_pd(r1, r2);
+        __m128d smaller = Select(r1, r2, _mm_cmplt_pd(r2, r1));
+        type = Select(type, Select(_mm_set1_pd(Sphere::SSI_EmptyInside), _mm_set1_pd(Sphere::SSI_Sphere), same), concentric);
+        cx = Select(cx, x1, concentric);
+        cy = Select(cy, y1, concentric);
+        cz = Select(cz, z1, concentric);
+        r = Select(r, Select(smaller, r1, same), concentric);
+        sign = Select(sign, one, concentric);
+
+        double types[width];
+        _mm_storeu_pd(types, type);
+        for (int j = 0; j < width; j++) {
+            result.type[i + j] = (Sphere::SSI_Type)(int)types[j];
+        }
+
+        _mm_storeu_pd(result.cx + i, cx);
+        _mm_storeu_pd(result.cy + i, cy);
+        _mm_storeu_pd(result.cz + i, cz);
+        _mm_storeu_pd(result.r + i, r);
+        _mm_storeu_pd(result.nx + i, _mm_mul_pd(sign, nx));
+        _mm_storeu_pd(result.ny + i, _mm_mul_pd(sign, ny));
+        _mm_storeu_pd(result.nz + i, _mm_mul_pd(sign, nz));
+    }
+
+    IntersectionRange<double, 3>(last, n, s1, s2, result);
+}
+#endif
 
-    return _c + v * _r;
+#ifdef QUIK_DISPATCH_AVX2
+// Select b where the mask is set, otherwise a
+__attribute__((target("avx2")))
+static inline __m256d Select(__m256d a, __m256d b, __m256d mask) {
+    return _mm256_blendv_pd(a, b, mask);
 }
 
-bool Sphere::IsValid(const Vec3 &p) const {
-    double d = _c.Distance(p);
+// IntersectionRange for four pairs at a time
+__attribute__((target("avx2")))
+static void IntersectionAVX2(int n, const Sphere::SphereArrays& s1, const Sphere::SphereArrays& s2, 
+                             const Sphere::IntersectionArrays& result) {
+    const int width = 4;
+    int last = n - n % width;
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d negativeZero = _mm256_set1_pd(-0.0);
+
+    for (int i = 0; i < last; i += width) {
+        __m256d x1 = _mm256_loadu_pd(s1.x + i);
+        __m256d y1 = _mm256_loadu_pd(s1.y + i);
+        __m256d z1 = _mm256_loadu_pd(s1.z + i);
+        __m256d r1 = _mm256_loadu_pd(s1.r + i);
+
+        __m256d x2 = _mm256_loadu_pd(s2.x + i);
+        __m256d y2 = _mm256_loadu_pd(s2.y + i);
+        __m256d z2 = _mm256_loadu_pd(s2.z + i);
+        __m256d r2 = _mm256_loadu_pd(s2.r + i);
+
+        __m256d nx = _mm256_sub_pd(x2, x1);
+        __m256d ny = _mm256_sub_pd(y2, y1);
+        __m256d nz = _mm256_sub_pd(z2, z1);
+        __m256d d = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(nx, nx), _mm256_mul_pd(ny, ny)), _mm256_mul_pd(nz, nz)));
+
+        __m256d scale = _mm256_div_pd(one, d);
+        __m256d concentric = _mm256_cmp_pd(d, zero, _CMP_LE_OQ);
+        nx = Select(_mm256_mul_pd(nx, scale), nx, concentric);
+        ny = Select(_mm256_mul_pd(ny, scale), ny, concentric);
+        nz = Select(_mm256_mul_pd(nz, scale), nz, concentric);
+
+        __m256d r1_2 = _mm256_mul_pd(r1, r1);
+        __m256d r2_2 = _mm256_mul_pd(r2, r2);
+        __m256d x = _mm256_div_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(d, d), r2_2), r1_2), _mm256_mul_pd(two, d));
+        __m256d clamped = Select(r1, _mm256_xor_pd(r1, negativeZero), _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+        x = Select(x, clamped, _mm256_cmp_pd(_mm256_andnot_pd(negativeZero, x), r1, _CMP_GT_OQ));
+
+        __m256d type = _mm256_set1_pd(Sphere::SSI_Circle);
+        __m256d cx = _mm256_add_pd(x1, _mm256_mul_pd(nx, x));
+        __m256d cy = _mm256_add_pd(y1, _mm256_mul_pd(ny, x));
+        __m256d cz = _mm256_add_pd(z1, _mm256_mul_pd(nz, x));
+        __m256d r = _mm256_sqrt_pd(_mm256_sub_pd(r1_2, _mm256_mul_pd(x, x)));
+        __m256d sign = one;
+
+        __m256d point = _mm256_cmp_pd(d, _mm256_add_pd(r1, r2), _CMP_EQ_OQ);
+        type = Select(type, _mm256_set1_pd(Sphere::SSI_Point), point);
+        cx = Select(cx, _mm256_add_pd(x1, _mm256_mul_pd(nx, r1)), point);
+        cy = Select(cy, _mm256_add_pd(y1, _mm256_mul_pd(ny, r1)), point);
+        cz = Select(cz, _mm256_add_pd(z1, _mm256_mul_pd(nz, r1)), point);
+        r = Select(r, zero, point);
+
+        __m256d inside2 = _mm256_cmp_pd(_mm256_add_pd(d, r1), r2, _CMP_LT_OQ);
+        type = Select(type, _mm256_set1_pd(Sphere::SSI_EmptyInside), inside2);
+        cx = Select(cx, x1, inside2);
+        cy = Select(cy, y1, inside2);
+        cz = Select(cz, z1, inside2);
+        r = Select(r, r1, inside2);
+        sign = Select(sign, _mm256_set1_pd(-1.0), inside2);
+
+        __m256d inside1 = _mm256_cmp_pd(_mm256_add_pd(d, r2), r1, _CMP_LT_OQ);
+        type = Select(type, _mm256_set1_pd(Sphere::SSI_EmptyInside), inside1);
+        cx = Select(cx, x2, inside1);
+        cy = Select(cy, y2, inside1);
+        cz = Select(cz, z2, inside1);
+        r = Select(r, r2, inside1);
+        sign = Select(sign, one, inside1);
+
+        __m256d outside = _mm256_cmp_pd(d, _mm256_add_pd(r1, r2), _CMP_GT_OQ);
+        type = Select(type, _mm256_set1_pd(Sphere::SSI_EmptyOutside), outside);
+        cx = Select(cx, x1, outside);
+        cy = Select(cy, y1, outside);
+        cz = Select(cz, z1, outside);
+        r = Select(r, r1, outside);
+        sign = Select(sign, one, outside);
+
+        __m256d same = _mm256_cmp_pd(r1, r2, _CMP_EQ_OQ);
+        __m256d smaller = Select(r1, r2, _mm256_cmp_pd(r2, r1, _CMP_LT_OQ));
+        type = Select(type, Select(_mm256_set1_pd(Sphere::SSI_EmptyInside), _mm256_set1_pd(Sphere::SSI_Sphere), same), concentric);
+        cx = Select(cx, x1, concentric);
+        cy = Select(cy, y1, concentric);
+        cz = Select(cz, z1, concentric);
+        r = Select(r, Select(smaller, r1, same), concentric);
+        sign = Select(sign, one, concentric);
+
+        double types[width];
+        _mm256_storeu_pd(types, type);
+        for (int j = 0; j < width; j++) {
+            result.type[i + j] = (Sphere::SSI_Type)(int)types[j];
+        }
+
+        _mm256_storeu_pd(result.cx + i, cx);
+        _mm256_storeu_pd(result.cy + i, cy);
+        _mm256_storeu_pd(result.cz + i, cz);
+        _mm256_storeu_pd(result.r + i, r);
+        _mm256_storeu_pd(result.nx + i, _mm256_mul_pd(sign, nx));
+        _mm256_storeu_pd(result.ny + i, _mm256_mul_pd(sign, ny));
+        _mm256_storeu_pd(result.nz + i, _mm256_mul_pd(sign, nz));
+    }
+
+    IntersectionRange<double, 3>(last, n, s1, s2, result);
+}
+#endif
 
-    return (d <= _r + epsilon) &&
-           (d >= _r - epsilon);
+template <class T, int D>
+void SphereT<T, D>::Intersection(int n, const SphereArrays& s1, const SphereArrays& s2, const IntersectionArrays& result) {
+    IntersectionRange<T, D>(0, n, s1, s2, result);
+}
+
+template <>
+void SphereT<double, 3>::Intersection(int n, const SphereArrays& s1, const SphereArrays& s2, const IntersectionArrays& result) {
+#ifdef QUIK_DISPATCH_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+
+    if (avx2) {
+        IntersectionAVX2(n, s1, s2, result);
+
+        return;
+    }
+#endif
+
+#ifdef QUIK_HAVE_SSE2
+    IntersectionSSE2(n, s1, s2, result);
+#else
+    IntersectionRange<double, 3>(0, n, s1, s2, result);
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 // Output to a stream
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
-std::ostream& operator<<(std::ostream& os, const Sphere& s) {
+template <class T, int D>
+std::ostream& operator<<(std::ostream& os, const SphereT<T, D>& s) {
     return (os << s._c << ", " << s._r);
-}
\ No newline at end of file
+}
+
+
+template class SphereT<float, 2>;
+template class SphereT<double, 2>;
+template class SphereT<Fixed, 2>;
+template class SphereT<float, 3>;
+template class SphereT<double, 3>;
+template class SphereT<Fixed, 3>;
+
+template std::ostream& operator<<(std::ostream& os, const SphereT<float, 2>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereT<double, 2>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereT<Fixed, 2>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereT<float, 3>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereT<double, 3>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereT<Fixed, 3>& s);
\ No newline at end of file
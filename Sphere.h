@@ -4,7 +4,8 @@
 //
 // Author:      David Borland
 //
-// Description: Sphere class.  
+// Description: Sphere class, a circle in 2D.  Templated on the scalar type and the dimension,
+//              with Sphere the 3D double version.
 //
 /////////////////////////////////////////////////////////////////////////////////////////////// 
 
@@ -13,39 +14,39 @@
 #define SPHERE_H
 
 
-#include "Vec3.h"
+#include "VecN.h"
+#include "ScalarTraits.h"
 
 
-class Sphere {
+template <class T, int D = 3>
+class SphereT {
 public:
+    typedef VecT<T, D> Vec;
+
     // Constructors
-    Sphere();                                       // Set to (0, 0, 0), 1
-    Sphere(const Vec3& c, double r);                // Set with center and radius    
+    SphereT();                                      // Set to the origin, 1
+    SphereT(const Vec& c, T r);                     // Set with center and radius    
 
     // Use default copy constructor
-
-
-    // Destructor
-    virtual ~Sphere();
-
-
+    // Use default destructor
     // Use default assignment operator
 
 
     // Set values
-    void MakeIdentity();                            // Set to (0, 0, 0), 1
-    void Set(const Vec3& c, double r);              // Set with center and radius
+    void MakeIdentity();                            // Set to the origin, 1
+    void Set(const Vec& c, T r);                    // Set with center and radius
 
         
     // Element access
-    Vec3& c();                                      // Read/write access
-    double& r();                                    // Read/write access
+    Vec& c();                                       // Read/write access
+    T& r();                                         // Read/write access
 
-    Vec3 c() const;                                 // Just read access
-    double r() const;                               // Just read access
+    Vec c() const;                                  // Just read access
+    T r() const;                                    // Just read access
 
 
-    // Sphere-sphere intersection
+    // Sphere-sphere intersection.  In 2D a circle is the two points at r from c, perpendicular 
+    // to n.
     enum SSI_Type {
         SSI_EmptyOutside,
         SSI_EmptyInside,
@@ -53,25 +54,143 @@ public:
         SSI_Circle,
         SSI_Sphere
     };
-    SSI_Type Intersection(const Sphere& s, Vec3& c, double& r, Vec3& n) const;
+    SSI_Type Intersection(const SphereT& s, Vec& c, T& r, Vec& n) const;
+
+    // Intersect spheres around the centers c1 and c2 for several pairs of radii, computing the 
+    // distance and direction between the centers once
+    static void Intersection(const Vec& c1, const Vec& c2, int numPairs, const T* r1, const T* r2,
+                             SSI_Type* type, Vec* c, T* r, Vec* n);
+
+    // Intersect with the distance d and unit direction n12 from c1 to c2 already computed
+    static SSI_Type Intersection(const Vec& c1, T r1, const Vec& c2, T r2, T d, const Vec& n12,
+                                 Vec& c, T& r, Vec& n);
+
+    // Spheres, circles or normals stored as arrays of each component.  The z arrays are not 
+    // used in 2D, and may be NULL.
+    struct SphereArrays {
+        const T* x;
+        const T* y;
+        const T* z;
+        const T* r;
+    };
+    struct IntersectionArrays {
+        SSI_Type* type;
+        T* cx;
+        T* cy;
+        T* cz;
+        T* r;
+        T* nx;
+        T* ny;
+        T* nz;
+    };
+
+    // Intersect sphere i of s1 with sphere i of s2 for n pairs, giving the same results as the 
+    // member function.  Branch free, using AVX2 for doubles if the processor has it.
+    static void Intersection(int n, const SphereArrays& s1, const SphereArrays& s2, const IntersectionArrays& result);
 
-    // Closest point on the sphere
-    virtual Vec3 ClosestPoint(const Vec3& p) const;
+    // Closest point on the sphere.  Not virtual; SphereInterior and SphereExterior define their 
+    // own on a private SphereT base.  Use SphereConstraint to mix them by value.
+    Vec ClosestPoint(const Vec& p) const;
 
     // Is point on the sphere
-    virtual bool IsValid(const Vec3& p) const;
+    bool IsValid(const Vec& p) const;
 
 
     // Output to a stream
-    friend std::ostream& operator<<(std::ostream& os, const Sphere& s);
+    template <class U, int E>
+    friend std::ostream& operator<<(std::ostream& os, const SphereT<U, E>& s);
 
 protected:
     // The internal representation
-    Vec3 _c;
-    double _r;
-
-    const static double epsilon;
+    Vec _c;
+    T _r;
 };
 
 
+typedef SphereT<double> Sphere;
+
+
+// 3D doubles use the SIMD version of the batch intersection
+template <>
+void SphereT<double, 3>::Intersection(int n, const SphereArrays& s1, const SphereArrays& s2, const IntersectionArrays& result);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline SphereT<T, D>::SphereT() {
+    MakeIdentity();
+}
+
+template <class T, int D>
+inline SphereT<T, D>::SphereT(const Vec& c, T r) {
+    Set(c, r);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline void SphereT<T, D>::MakeIdentity() {
+    Set(Vec(), T(1));
+}
+
+template <class T, int D>
+inline void SphereT<T, D>::Set(const Vec& c, T r) {
+    _c = c;
+    _r = r;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D>& SphereT<T, D>::c() {
+    return _c;
+}
+
+template <class T, int D>
+inline T& SphereT<T, D>::r() {
+    return _r;
+}
+
+
+template <class T, int D>
+inline VecT<T, D> SphereT<T, D>::c() const {
+    return _c;
+}
+
+template <class T, int D>
+inline T SphereT<T, D>::r() const {
+    return _r;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D> SphereT<T, D>::ClosestPoint(const Vec& p) const {
+    Vec v = p - _c;
+    v.Normalize();
+
+    return _c + v * _r;
+}
+
+template <class T, int D>
+inline bool SphereT<T, D>::IsValid(const Vec &p) const {
+    T epsilon = ScalarTraits<T>::Epsilon();
+
+    return _c.WithinDistance(p, _r + epsilon) &&
+           _c.BeyondDistance(p, _r - epsilon);
+}
+
+
 #endif
\ No newline at end of file
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SphereConstraint.h
+//
+// Author:      David Borland
+//
+// Description: A sphere, its interior, or its exterior, held by value.  The type is stored
+//              as a tag and dispatched with a switch, so constraints of mixed types can be
+//              kept in one array without pointers or virtual calls.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SPHERECONSTRAINT_H
+#define SPHERECONSTRAINT_H
+
+
+#include "Sphere.h"
+#include "SphereInterior.h"
+#include "SphereExterior.h"
+
+
+template <class T, int D = 3>
+class SphereConstraintT {
+public:
+    typedef VecT<T, D> Vec;
+    typedef SphereT<T, D> Sphere;
+    typedef SphereInteriorT<T, D> SphereInterior;
+    typedef SphereExteriorT<T, D> SphereExterior;
+
+    // Type of constraint
+    enum ConstraintType {
+        SurfaceConstraint,
+        InteriorConstraint,
+        ExteriorConstraint
+    };
+
+    // Constructors
+    SphereConstraintT();                                    // Surface of the origin, 1
+    SphereConstraintT(const Sphere& s);                     // Surface of the sphere
+    SphereConstraintT(const SphereInterior& s);             // Interior of the sphere
+    SphereConstraintT(const SphereExterior& s);             // Exterior of the sphere
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Element access
+    ConstraintType GetType() const;
+    Vec c() const;
+    T r() const;
+
+
+    // Closest point that satisfies the constraint
+    Vec ClosestPoint(const Vec& p) const;
+
+    // Does the point satisfy the constraint
+    bool IsValid(const Vec& p) const;
+
+protected:
+    // The internal representation
+    ConstraintType _type;
+    Vec _c;
+    T _r;
+};
+
+
+typedef SphereConstraintT<double> SphereConstraint;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline SphereConstraintT<T, D>::SphereConstraintT()
+: _type(SurfaceConstraint), _c(), _r(T(1)) {
+}
+
+template <class T, int D>
+inline SphereConstraintT<T, D>::SphereConstraintT(const Sphere& s)
+: _type(SurfaceConstraint), _c(s.c()), _r(s.r()) {
+}
+
+template <class T, int D>
+inline SphereConstraintT<T, D>::SphereConstraintT(const SphereInterior& s)
+: _type(InteriorConstraint), _c(s.c()), _r(s.r()) {
+}
+
+template <class T, int D>
+inline SphereConstraintT<T, D>::SphereConstraintT(const SphereExterior& s)
+: _type(ExteriorConstraint), _c(s.c()), _r(s.r()) {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline typename SphereConstraintT<T, D>::ConstraintType SphereConstraintT<T, D>::GetType() const {
+    return _type;
+}
+
+template <class T, int D>
+inline VecT<T, D> SphereConstraintT<T, D>::c() const {
+    return _c;
+}
+
+template <class T, int D>
+inline T SphereConstraintT<T, D>::r() const {
+    return _r;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D> SphereConstraintT<T, D>::ClosestPoint(const Vec& p) const {
+    switch (_type) {
+        case InteriorConstraint:
+            return SphereInterior(_c, _r).ClosestPoint(p);
+
+        case ExteriorConstraint:
+            return SphereExterior(_c, _r).ClosestPoint(p);
+
+        case SurfaceConstraint:
+        default:
+            return Sphere(_c, _r).ClosestPoint(p);
+    }
+}
+
+template <class T, int D>
+inline bool SphereConstraintT<T, D>::IsValid(const Vec& p) const {
+    switch (_type) {
+        case InteriorConstraint:
+            return SphereInterior(_c, _r).IsValid(p);
+
+        case ExteriorConstraint:
+            return SphereExterior(_c, _r).IsValid(p);
+
+        case SurfaceConstraint:
+        default:
+            return Sphere(_c, _r).IsValid(p);
+    }
+}
+
+
+#endif
\ No newline at end of file
@@ -16,21 +16,74 @@
 #include "Sphere.h"
 
 
-class SphereExterior : public Sphere {
+template <class T, int D = 3>
+class SphereExteriorT : private SphereT<T, D> {
 public:
+    typedef VecT<T, D> Vec;
+    typedef SphereT<T, D> Sphere;
+
     // Constructors
-    SphereExterior();                                       // Set to (0, 0, 0), 1
-    SphereExterior(const Vec3& c, double r);                // Set with center and radius
+    SphereExteriorT();                                      // Set to the origin, 1
+    SphereExteriorT(const Vec& c, T r);                     // Set with center and radius
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set values and element access, as for the sphere.  The sphere is a private base, so 
+    // this cannot be passed as a sphere and have its surface tests used instead of these.
+    using Sphere::MakeIdentity;
+    using Sphere::Set;
+    using Sphere::c;
+    using Sphere::r;
 
-    // Destructor
-    virtual ~SphereExterior();
 
     // Closest point on or outside the sphere
-    virtual Vec3 ClosestPoint(const Vec3& p) const;
+    Vec ClosestPoint(const Vec& p) const;
 
     // Is point on or outside the sphere
-    virtual bool IsValid(const Vec3& p) const;
+    bool IsValid(const Vec& p) const;
 };
 
 
+typedef SphereExteriorT<double> SphereExterior;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline SphereExteriorT<T, D>::SphereExteriorT() : SphereT<T, D>() {
+}
+
+template <class T, int D>
+inline SphereExteriorT<T, D>::SphereExteriorT(const Vec& c, T r) : SphereT<T, D>(c, r) {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D> SphereExteriorT<T, D>::ClosestPoint(const Vec& p) const {
+    if (this->_c.BeyondDistance(p, this->_r)) {
+        return p;
+    }
+    else {
+        Vec v = p - this->_c;
+        v.Normalize();
+
+        return this->_c + v * this->_r;
+    }
+}
+
+template <class T, int D>
+inline bool SphereExteriorT<T, D>::IsValid(const Vec &p) const {
+    return this->_c.BeyondDistance(p, this->_r - ScalarTraits<T>::Epsilon());
+}
+
+
 #endif
\ No newline at end of file
@@ -16,21 +16,74 @@
 #include "Sphere.h"
 
 
-class SphereInterior : public Sphere {
+template <class T, int D = 3>
+class SphereInteriorT : private SphereT<T, D> {
 public:
+    typedef VecT<T, D> Vec;
+    typedef SphereT<T, D> Sphere;
+
     // Constructors
-    SphereInterior();                                       // Set to (0, 0, 0), 1
-    SphereInterior(const Vec3& c, double r);                // Set with center and radius
+    SphereInteriorT();                                      // Set to the origin, 1
+    SphereInteriorT(const Vec& c, T r);                     // Set with center and radius
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set values and element access, as for the sphere.  The sphere is a private base, so 
+    // this cannot be passed as a sphere and have its surface tests used instead of these.
+    using Sphere::MakeIdentity;
+    using Sphere::Set;
+    using Sphere::c;
+    using Sphere::r;
 
-    // Destructor
-    virtual ~SphereInterior();
 
     // Closest point on or inside the sphere
-    virtual Vec3 ClosestPoint(const Vec3& p) const;
+    Vec ClosestPoint(const Vec& p) const;
 
     // Is point on or inside the sphere
-    virtual bool IsValid(const Vec3& p) const;
+    bool IsValid(const Vec& p) const;
 };
 
 
+typedef SphereInteriorT<double> SphereInterior;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline SphereInteriorT<T, D>::SphereInteriorT() : SphereT<T, D>() {
+}
+
+template <class T, int D>
+inline SphereInteriorT<T, D>::SphereInteriorT(const Vec& c, T r) : SphereT<T, D>(c, r) {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D> SphereInteriorT<T, D>::ClosestPoint(const Vec& p) const {
+    if (this->_c.WithinDistance(p, this->_r)) {
+        return p;
+    }
+    else {
+        Vec v = p - this->_c;
+        v.Normalize();
+
+        return this->_c + v * this->_r;
+    }
+}
+
+template <class T, int D>
+inline bool SphereInteriorT<T, D>::IsValid(const Vec &p) const {
+    return this->_c.WithinDistance(p, this->_r + ScalarTraits<T>::Epsilon());
+}
+
+
 #endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SphereShell.cpp
+//
+// Author:      David Borland
+//
+// Description: Class that represents a spherical shell.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "SphereShell.h"
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Output to a stream
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+std::ostream& operator<<(std::ostream& os, const SphereShellT<T, D>& s) {
+    return (os << s._c << ", " << s._rMin << ", " << s._rMax);
+}
+
+
+template std::ostream& operator<<(std::ostream& os, const SphereShellT<float, 2>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereShellT<double, 2>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereShellT<Fixed, 2>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereShellT<float, 3>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereShellT<double, 3>& s);
+template std::ostream& operator<<(std::ostream& os, const SphereShellT<Fixed, 3>& s);
\ No newline at end of file
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SphereShell.h
+//
+// Author:      David Borland
+//
+// Description: Class that represents a spherical shell, the points between a minimum and
+//              maximum radius around a center.  Equivalent to a SphereExterior for the
+//              minimum radius and a SphereInterior for the maximum radius with the same
+//              center, but computes the distance to the center once for both.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SPHERESHELL_H
+#define SPHERESHELL_H
+
+
+#include "VecN.h"
+#include "Sphere.h"
+
+#include <cmath>
+#include <iostream>
+
+
+template <class T, int D = 3>
+class SphereShellT {
+public:
+    typedef VecT<T, D> Vec;
+    typedef SphereT<T, D> Sphere;
+
+    // Constructors
+    SphereShellT();                                         // Set to the origin, 0, 1
+    SphereShellT(const Vec& c, T rMin, T rMax);             // Set with center and radii
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set values
+    void MakeIdentity();                                    // Set to the origin, 0, 1
+    void Set(const Vec& c, T rMin, T rMax);                 // Set with center and radii
+
+
+    // Element access
+    Vec& c();                                               // Read/write access
+    T& rMin();                                              // Read/write access
+    T& rMax();                                              // Read/write access
+
+    Vec c() const;                                          // Just read access
+    T rMin() const;                                         // Just read access
+    T rMax() const;                                         // Just read access
+
+    Sphere MinSphere() const;                               // Inner boundary
+    Sphere MaxSphere() const;                               // Outer boundary
+
+
+    // Closest point in the shell
+    Vec ClosestPoint(const Vec& p) const;
+
+    // Is point in the shell
+    bool IsValid(const Vec& p) const;
+
+    // Squared distances from the center that IsValid accepts, for testing many points
+    void ValidRange(T& minSquared, T& maxSquared) const;
+
+
+    // Output to a stream
+    template <class U, int E>
+    friend std::ostream& operator<<(std::ostream& os, const SphereShellT<U, E>& s);
+
+protected:
+    // The internal representation
+    Vec _c;
+    T _rMin;
+    T _rMax;
+};
+
+
+typedef SphereShellT<double> SphereShell;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline SphereShellT<T, D>::SphereShellT() {
+    MakeIdentity();
+}
+
+template <class T, int D>
+inline SphereShellT<T, D>::SphereShellT(const Vec& c, T rMin, T rMax) {
+    Set(c, rMin, rMax);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline void SphereShellT<T, D>::MakeIdentity() {
+    Set(Vec(), T(0), T(1));
+}
+
+template <class T, int D>
+inline void SphereShellT<T, D>::Set(const Vec& c, T rMin, T rMax) {
+    _c = c;
+    _rMin = rMin;
+    _rMax = rMax;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D>& SphereShellT<T, D>::c() {
+    return _c;
+}
+
+template <class T, int D>
+inline T& SphereShellT<T, D>::rMin() {
+    return _rMin;
+}
+
+template <class T, int D>
+inline T& SphereShellT<T, D>::rMax() {
+    return _rMax;
+}
+
+
+template <class T, int D>
+inline VecT<T, D> SphereShellT<T, D>::c() const {
+    return _c;
+}
+
+template <class T, int D>
+inline T SphereShellT<T, D>::rMin() const {
+    return _rMin;
+}
+
+template <class T, int D>
+inline T SphereShellT<T, D>::rMax() const {
+    return _rMax;
+}
+
+
+template <class T, int D>
+inline SphereT<T, D> SphereShellT<T, D>::MinSphere() const {
+    return Sphere(_c, _rMin);
+}
+
+template <class T, int D>
+inline SphereT<T, D> SphereShellT<T, D>::MaxSphere() const {
+    return Sphere(_c, _rMax);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int D>
+inline VecT<T, D> SphereShellT<T, D>::ClosestPoint(const Vec& p) const {
+    using std::sqrt;
+
+    Vec v = p - _c;
+    T d2 = v.MagnitudeSquared();
+
+    // Same tests as SphereInterior and SphereExterior, sharing the squared distance
+    bool insideMax = _rMax >= T(0) && d2 <= _rMax * _rMax;
+    bool outsideMin = _rMin <= T(0) || d2 >= _rMin * _rMin;
+
+    if (insideMax && outsideMin) {
+        return p;
+    }
+
+    // Project onto the violated boundary, normalizing as Vec3::Normalize() does
+    T magnitude = sqrt(d2);
+    if (magnitude > T(0)) {
+        v *= T(1) / magnitude;
+    }
+
+    return _c + v * (insideMax ? _rMin : _rMax);
+}
+
+template <class T, int D>
+inline bool SphereShellT<T, D>::IsValid(const Vec &p) const {
+    T minSquared;
+    T maxSquared;
+    ValidRange(minSquared, maxSquared);
+
+    T d2 = _c.DistanceSquared(p);
+
+    return d2 >= minSquared && d2 <= maxSquared;
+}
+
+template <class T, int D>
+inline void SphereShellT<T, D>::ValidRange(T& minSquared, T& maxSquared) const {
+    T epsilon = ScalarTraits<T>::Epsilon();
+    T rMin = _rMin - epsilon;
+    T rMax = _rMax + epsilon;
+
+    // Squared distances are never negative, so a negative maximum accepts nothing
+    minSquared = rMin <= T(0) ? T(0) : rMin * rMin;
+    maxSquared = rMax >= T(0) ? rMax * rMax : T(-1);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        StaticQuIK.h
+//
+// Author:      David Borland
+//
+// Description: Solves the IK for a chain with a number of joints fixed at compile time, such
+//              as a 3-, 4- or 7-joint arm or leg.  The joint order and priorities are also
+//              template parameters, so the plan is compiled with the program and the joint
+//              placements are unrolled, and the chain, radii and plan are held in arrays
+//              inside the object.  The last joint is the target joint.  Gives the same
+//              results as QuIK with the same settings.
+//
+//              Only the plan lookups are removed.  Each placement calls the same
+//              out-of-line placement functions as QuIK, which dominate the solve above
+//              about 4 joints, so longer chains see no reliable gain over QuIK.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef STATICQUIK_H
+#define STATICQUIK_H
+
+
+#include "QuIK.h"
+#include "ChainReach.h"
+#include "Vec3.h"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+
+// Placement of the current joint using the start and end joints
+struct StaticPlacement {
+    int start;
+    int current;
+    int end;
+};
+
+// Placements for N joints, with room for as many as QuIK::CompilePlan() reserves
+template <int N>
+struct StaticPlan {
+    StaticPlacement placements[2 * N];
+    int numPlacements;
+};
+
+
+// The plan QuIK::CompilePlan() makes for a single pass solve of N joints with the given joint
+// order and priorities, targeting the last joint
+template <int N, QuIK::JointOrderType Order, int... Priorities>
+constexpr StaticPlan<N> CompileStaticPlan() {
+    StaticPlan<N> plan{};
+
+    // Rank the priorities, then the target joint, keeping the first rank of a repeated joint
+    int rank[N] = {};
+    for (int i = 0; i < N; i++) {
+        rank[i] = -1;
+    }
+
+    const int priorities[] = { Priorities..., N - 1 };
+    int numRanks = 0;
+    for (int i = 0; i < (int)(sizeof(priorities) / sizeof(priorities[0])); i++) {
+        if (rank[priorities[i]] == -1) rank[priorities[i]] = numRanks++;
+    }
+
+    // Work through the intervals with a stack, as QuIK::CompilePlan() does
+    int starts[2 * N] = {};
+    int ends[2 * N] = {};
+    int numIntervals = 1;
+    starts[0] = 0;
+    ends[0] = N - 1;
+
+    while (numIntervals > 0) {
+        numIntervals--;
+        int start = starts[numIntervals];
+        int end = ends[numIntervals];
+
+        // Use the highest-ranked priority inside the interval, removing it
+        int current = -1;
+        for (int i = start + 1; i < end; i++) {
+            if (rank[i] != -1 && (current == -1 || rank[i] < rank[current])) current = i;
+        }
+
+        if (current != -1) {
+            rank[current] = -1;
+        }
+        else if (Order == QuIK::DecreasingJointOrder) {
+            current = end - 1;
+        }
+        else if (Order == QuIK::DividingJointOrder) {
+            current = (start + end) / 2;
+        }
+        else {
+            current = start + 1;
+        }
+
+        StaticPlacement& p = plan.placements[plan.numPlacements++];
+        p.start = start;
+        p.current = current;
+        p.end = end;
+
+        if (end - start > 2) {
+            starts[numIntervals] = current;
+            ends[numIntervals] = end;
+            numIntervals++;
+
+            starts[numIntervals] = start;
+            ends[numIntervals] = current;
+            numIntervals++;
+        }
+    }
+
+    return plan;
+}
+
+// Whether the priorities are all interior joints of N joints
+template <int N, int... Priorities>
+constexpr bool InteriorJoints() {
+    const int priorities[] = { Priorities..., 0 };
+    for (int i = 0; i < (int)sizeof...(Priorities); i++) {
+        if (priorities[i] <= 0 || priorities[i] >= N - 1) return false;
+    }
+
+    return true;
+}
+
+
+template <class T, int N, QuIK::JointOrderType Order = QuIK::DividingJointOrder, int... Priorities>
+class StaticQuIKT {
+public:
+    typedef Vec3T<T> Vec3;
+
+    static_assert(N >= 2, "A chain needs at least two joints");
+    static_assert(InteriorJoints<N, Priorities...>(), "Priorities must be interior joints");
+
+
+    // Constructor
+    StaticQuIKT();                                  // Bones of length 1 along the x axis
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set bones or joints
+    void SetBones(const std::array<T, N - 1>& boneLengths);
+    void SetJoints(const std::array<Vec3, N>& jointPositions);
+
+    // Get/set target for the last joint
+    const Vec3& GetTarget() const;
+    void SetTarget(const Vec3& targetPosition);
+
+    // Joint placement
+    QuIK::JointPlacementType GetJointPlacementType() const;
+    void SetJointPlacementType(QuIK::JointPlacementType type);
+
+    // Solve
+    void SolveIK();
+
+    // Get bone lengths and joint positions
+    const std::array<T, N - 1>& GetLengths() const;
+    const std::array<Vec3, N>& GetPositions() const;
+
+
+    // The plan, compiled with the program
+    static constexpr StaticPlan<N> plan = CompileStaticPlan<N, Order, Priorities...>();
+    static constexpr int NumJoints = N;
+    static constexpr int NumPlacements = plan.numPlacements;
+
+protected:
+    // Compute the radii for each placement from the bone lengths
+    void CreateRadii();
+
+    // Place joints in the order of the plan
+    template <int... I>
+    void PlaceJointsTriangulation(std::integer_sequence<int, I...>);
+    template <int... I>
+    void PlaceJointsInertial(std::integer_sequence<int, I...>);
+
+    template <int I>
+    void PlaceJointTriangulation();
+    template <int I>
+    void PlaceJointInertial();
+
+
+    // Bone chain
+    std::array<T, N - 1> lengths;
+    std::array<Vec3, N> positions;
+
+    // Reach of the start and end joints for each placement, and of the last joint from the first
+    struct PlacementRadii {
+        T rMax1;
+        T rMin1;
+        T rMax2;
+        T rMin2;
+    };
+    std::array<PlacementRadii, NumPlacements> radii;
+    T maxRadius;
+    T minRadius;
+
+    // Target position
+    Vec3 target;
+
+    // Algorithm parameters
+    QuIK::JointPlacementType jointPlacementType;
+};
+
+
+// Double version
+template <int N, QuIK::JointOrderType Order = QuIK::DividingJointOrder, int... Priorities>
+using StaticQuIK = StaticQuIKT<double, N, Order, Priorities...>;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Static members
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+constexpr StaticPlan<N> StaticQuIKT<T, N, Order, Priorities...>::plan;
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+constexpr int StaticQuIKT<T, N, Order, Priorities...>::NumJoints;
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+constexpr int StaticQuIKT<T, N, Order, Priorities...>::NumPlacements;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline StaticQuIKT<T, N, Order, Priorities...>::StaticQuIKT() {
+    jointPlacementType = QuIK::TriangulationJointPlacement;
+
+    std::array<T, N - 1> boneLengths;
+    boneLengths.fill(T(1));
+
+    SetBones(boneLengths);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline void StaticQuIKT<T, N, Order, Priorities...>::SetBones(const std::array<T, N - 1>& boneLengths) {
+    lengths = boneLengths;
+
+    // Create initial positions along the x axis
+    positions[0] = Vec3();
+    for (int i = 1; i < N; i++) {
+        positions[i] = positions[i - 1] + Vec3(lengths[i - 1], T(0), T(0));
+    }
+
+    CreateRadii();
+}
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline void StaticQuIKT<T, N, Order, Priorities...>::SetJoints(const std::array<Vec3, N>& jointPositions) {
+    positions = jointPositions;
+
+    // Compute the bone lengths
+    for (int i = 0; i < N - 1; i++) {
+        lengths[i] = positions[i].Distance(positions[i + 1]);
+    }
+
+    CreateRadii();
+}
+
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline const Vec3T<T>& StaticQuIKT<T, N, Order, Priorities...>::GetTarget() const {
+    return target;
+}
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline void StaticQuIKT<T, N, Order, Priorities...>::SetTarget(const Vec3& targetPosition) {
+    target = targetPosition;
+}
+
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline QuIK::JointPlacementType StaticQuIKT<T, N, Order, Priorities...>::GetJointPlacementType() const {
+    return jointPlacementType;
+}
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline void StaticQuIKT<T, N, Order, Priorities...>::SetJointPlacementType(QuIK::JointPlacementType type) {
+    jointPlacementType = type;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Solve
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline void StaticQuIKT<T, N, Order, Priorities...>::SolveIK() {
+    positions[N - 1] = QuIKT<T>::PlaceLastJoint(positions[0], positions[N - 1], target, maxRadius, minRadius);
+
+    switch (jointPlacementType) {
+
+        case QuIK::TriangulationJointPlacement:
+
+            PlaceJointsTriangulation(std::make_integer_sequence<int, NumPlacements>());
+
+            break;
+
+        case QuIK::InertialJointPlacement:
+
+            PlaceJointsInertial(std::make_integer_sequence<int, NumPlacements>());
+
+            break;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline const std::array<T, N - 1>& StaticQuIKT<T, N, Order, Priorities...>::GetLengths() const {
+    return lengths;
+}
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline const std::array<Vec3T<T>, N>& StaticQuIKT<T, N, Order, Priorities...>::GetPositions() const {
+    return positions;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+inline void StaticQuIKT<T, N, Order, Priorities...>::CreateRadii() {
+    // The same radii as QuIK, which gets them from its reach
+    ChainReachT<T> reach;
+    reach.Set(std::vector<T>(lengths.begin(), lengths.end()));
+
+    for (int i = 0; i < NumPlacements; i++) {
+        const StaticPlacement& p = plan.placements[i];
+
+        radii[i].rMax1 = reach.MaxRadius(p.start, p.current);
+        radii[i].rMin1 = reach.MinRadius(p.start, p.current);
+        radii[i].rMax2 = reach.MaxRadius(p.end, p.current);
+        radii[i].rMin2 = reach.MinRadius(p.end, p.current);
+    }
+
+    maxRadius = reach.MaxRadius(0, N - 1);
+    minRadius = reach.MinRadius(0, N - 1);
+}
+
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+template <int... I>
+inline void StaticQuIKT<T, N, Order, Priorities...>::PlaceJointsTriangulation(std::integer_sequence<int, I...>) {
+    // Expand the joints in order, as the elements of an array
+    int placed[] = { 0, (PlaceJointTriangulation<I>(), 0)... };
+    (void)placed;
+}
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+template <int... I>
+inline void StaticQuIKT<T, N, Order, Priorities...>::PlaceJointsInertial(std::integer_sequence<int, I...>) {
+    int placed[] = { 0, (PlaceJointInertial<I>(), 0)... };
+    (void)placed;
+}
+
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+template <int I>
+inline void StaticQuIKT<T, N, Order, Priorities...>::PlaceJointTriangulation() {
+    constexpr StaticPlacement p = plan.placements[I];
+
+    positions[p.current] = QuIKT<T>::PlaceJointTriangulation(positions[p.current], positions[p.start], positions[p.end],
+                                                             radii[I].rMax1, radii[I].rMax2);
+}
+
+template <class T, int N, QuIK::JointOrderType Order, int... Priorities>
+template <int I>
+inline void StaticQuIKT<T, N, Order, Priorities...>::PlaceJointInertial() {
+    constexpr StaticPlacement p = plan.placements[I];
+
+    positions[p.current] = QuIKT<T>::PlaceJointInertial(positions[p.current], positions[p.start], positions[p.end],
+                                                        radii[I].rMax1, radii[I].rMin1, radii[I].rMax2, radii[I].rMin2);
+}
+
+
+#endif
\ No newline at end of file
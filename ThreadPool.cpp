@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ThreadPool.cpp
+//
+// Author:      David Borland
+//
+// Description: Persistent pool of worker threads with work stealing.  Each worker has its 
+//              own queue of tasks, takes the most recent from its own queue, and steals the 
+//              oldest from other queues when its own is empty.  Threads that wait for a 
+//              group of tasks run tasks while they wait, so tasks can run and wait for 
+//              their own subtasks.  Threads outside the pool each get their own queue when 
+//              they first queue or wait, so any number of them can submit at once.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <functional>
+
+
+// Pool that the current thread works for, and its queue
+static thread_local ThreadPool* currentPool = NULL;
+static thread_local int currentQueue = 0;
+
+// Id of the pool outside of which the current thread last queued or waited, and its queue 
+// there
+static thread_local long outsidePool = 0;
+static thread_local int outsideQueue = 0;
+
+// Number of pools created, giving each an id
+static std::atomic<long> numPools(0);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+ThreadPool::ThreadPool(int numThreads) {
+    if (numThreads < 0) {
+        numThreads = (int)std::thread::hardware_concurrency() - 1;
+        if (numThreads < 0) numThreads = 0;
+    }
+
+    numWorkers = numThreads;
+    id = ++numPools;
+
+    numOutsideQueues = 0;
+    numQueued = 0;
+    stop = false;
+
+    // One queue per worker, then enough for one outside thread per core or per worker
+    int numOutside = std::max((int)std::thread::hardware_concurrency(), numThreads + 1);
+
+    for (int i = 0; i < numThreads + numOutside; i++) {
+        queues.push_back(new TaskQueue());
+    }
+
+    for (int i = 0; i < numThreads; i++) {
+        threads.push_back(std::thread(&ThreadPool::Work, this, i));
+    }
+}
+
+ThreadPool::TaskGroup::TaskGroup() {
+    _numPending = 0;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Destructor
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stop = true;
+    }
+    wake.notify_all();
+
+    for (int i = 0; i < (int)threads.size(); i++) {
+        threads[i].join();
+    }
+
+    for (int i = 0; i < (int)queues.size(); i++) {
+        delete queues[i];
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Global pool
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+ThreadPool& ThreadPool::GetGlobal() {
+    static ThreadPool pool;
+
+    return pool;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+int ThreadPool::GetNumThreads() const {
+    return threads.size();
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Tasks
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::Run(TaskGroup& group, TaskFunction function, void* data, int index) {
+    Task task;
+    task.function = function;
+    task.data = data;
+    task.index = index;
+    task.group = &group;
+
+    group._numPending++;
+
+    // Add to the calling thread's queue
+    TaskQueue* queue = queues[GetQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->tasks.push_back(task);
+    }
+
+    // Wake a sleeping worker.  Counting under the lock means a worker cannot miss the 
+    // task between checking the count and going to sleep.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        numQueued.fetch_add(1, std::memory_order_release);
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::Wait(TaskGroup& group) {
+    int queue = GetQueue();
+
+    while (group._numPending > 0) {
+        if (!RunTask(queue)) {
+            // Tasks in the group are running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Workers
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::Work(int queue) {
+    currentPool = this;
+    currentQueue = queue;
+
+    while (true) {
+        if (RunTask(queue)) continue;
+
+        // Sleep until there is something to do
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stop || numQueued.load(std::memory_order_acquire) > 0; });
+
+        if (stop) return;
+    }
+}
+
+bool ThreadPool::RunTask(int queue) {
+    Task task;
+    bool found = false;
+
+    // Newest task from this thread's queue
+    {
+        TaskQueue* q = queues[queue];
+        std::lock_guard<std::mutex> lock(q->mutex);
+
+        if (!q->tasks.empty()) {
+            task = q->tasks.back();
+            q->tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // Oldest task from another queue in use
+    int numQueues = numWorkers + numOutsideQueues.load(std::memory_order_acquire);
+
+    for (int i = 1; !found && i < numQueues; i++) {
+        TaskQueue* q = queues[(queue + i) % numQueues];
+        std::lock_guard<std::mutex> lock(q->mutex);
+
+        if (!q->tasks.empty()) {
+            task = q->tasks.front();
+            q->tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) return false;
+
+    // Lowering the count never needs to wake a worker, so it does not take the lock
+    numQueued.fetch_sub(1, std::memory_order_release);
+
+    task.function(task.data, task.index);
+    task.group->_numPending--;
+
+    return true;
+}
+
+int ThreadPool::GetQueue() {
+    if (currentPool == this) return currentQueue;
+
+    if (outsidePool != id) {
+        // First use of this pool by an outside thread, or use after another pool.  Take 
+        // the next outside queue, or share one picked by thread once all are taken.
+        int numOutside = (int)queues.size() - numWorkers;
+        int outside = numOutsideQueues.load(std::memory_order_relaxed);
+
+        while (outside < numOutside && 
+               !numOutsideQueues.compare_exchange_weak(outside, outside + 1, std::memory_order_acq_rel)) {}
+
+        if (outside >= numOutside) {
+            outside = (int)(std::hash<std::thread::id>()(std::this_thread::get_id()) % numOutside);
+        }
+
+        outsidePool = id;
+        outsideQueue = numWorkers + outside;
+    }
+
+    return outsideQueue;
+}
\ No newline at end of file
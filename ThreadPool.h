@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ThreadPool.h
+//
+// Author:      David Borland
+//
+// Description: Persistent pool of worker threads with work stealing.  Each worker has its 
+//              own queue of tasks, takes the most recent from its own queue, and steals the 
+//              oldest from other queues when its own is empty.  Threads that wait for a 
+//              group of tasks run tasks while they wait, so tasks can run and wait for 
+//              their own subtasks.  Threads outside the pool each get their own queue when 
+//              they first queue or wait, so any number of them can submit at once.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////// 
+
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+class ThreadPool {
+public:
+    // Constructor.  Uses one thread per core, less the thread calling Wait(), by default.
+    ThreadPool(int numThreads = -1);
+
+    // Destructor, stops the threads
+    ~ThreadPool();
+
+    // Pool shared by all users that do not set their own
+    static ThreadPool& GetGlobal();
+
+
+    // Number of worker threads.  Threads calling Wait() also run tasks.
+    int GetNumThreads() const;
+
+
+    // Tasks that can be waited on together
+    class TaskGroup {
+    public:
+        TaskGroup();
+
+    protected:
+        friend class ThreadPool;
+
+        std::atomic<int> _numPending;
+    };
+
+    // Task function, called with the data and index given to Run()
+    typedef void (*TaskFunction)(void* data, int index);
+
+    // Queue a task
+    void Run(TaskGroup& group, TaskFunction function, void* data, int index);
+
+    // Run tasks until all tasks in the group have finished
+    void Wait(TaskGroup& group);
+
+protected:
+    // Use no copy constructor or assignment operator
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+
+    struct Task {
+        TaskFunction function;
+        void* data;
+        int index;
+        TaskGroup* group;
+    };
+
+    // Queue of tasks for one thread
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Worker thread main loop
+    void Work(int queue);
+
+    // Run one task from the given queue, or steal one from another, if there are any
+    bool RunTask(int queue);
+
+    // Queue for the calling thread, taking a queue for a thread outside the pool
+    int GetQueue();
+
+
+    // One queue per worker, then queues for threads outside the pool.  All are created 
+    // with the pool, so workers can read the list while outside threads take queues.
+    std::vector<TaskQueue*> queues;
+    std::vector<std::thread> threads;
+    int numWorkers;
+
+    // Identifies the pool to outside threads, which may outlive it and see another pool at 
+    // its address
+    long id;
+
+    // Number of queues taken by outside threads.  Once all are taken, further outside 
+    // threads share them.
+    std::atomic<int> numOutsideQueues;
+
+    // Number of queued tasks, used to put idle workers to sleep
+    std::atomic<int> numQueued;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    bool stop;
+};
+
+
+#endif
\ No newline at end of file
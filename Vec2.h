@@ -0,0 +1,336 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        Vec2.h
+//
+// Author:      David Borland
+//
+// Description: 2D vector class, for planar chains.  The same interface as Vec3T without the
+//              z component and the cross product.  Templated on the scalar type and defined
+//              entirely in the header, so it can be inlined.  Vec2 is the double version.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef VEC2_H
+#define VEC2_H
+
+
+#include <math.h>
+
+#include <iostream>
+
+
+template <class T>
+class Vec2T {
+public:
+    // Number of components
+    static const int Dimension = 2;
+
+
+    // Constructors
+    constexpr Vec2T();                              // Set to (0, 0)
+    constexpr Vec2T(const T v[2]);                  // Set from array
+    constexpr Vec2T(T x, T y);                      // Set components
+
+
+    // Use default copy constructor
+    // Use default destructor
+    // Use default assignment operator
+
+
+    // Set values
+    void MakeIdentity();                            // Set to (0, 0)
+    void Set(const T v[2]);                         // Set from array
+    void Set(T x, T y);                             // Set components
+
+
+    // Element access
+    T& x();                                         // Read/write access
+    T& y();                                         // Read/write access
+
+    constexpr T x() const;                          // Just read access
+    constexpr T y() const;                          // Just read access
+
+
+    // Operators
+    T& operator[](int i);                           // Index, read/write access
+    constexpr T operator[](int i) const;            // Index
+
+    constexpr const Vec2T operator+(const Vec2T& v) const;  // Vector addition
+    constexpr const Vec2T operator-(const Vec2T& v) const;  // Vector subtraction
+
+    constexpr const Vec2T operator*(T scale) const;         // Scale
+
+    Vec2T& operator+=(const Vec2T& v);              // Vector addition
+    Vec2T& operator-=(const Vec2T& v);              // Vector subtraction
+
+    Vec2T& operator*=(T scale);                     // Scale
+
+    constexpr const Vec2T operator!() const;        // Invert
+
+    constexpr bool operator==(const Vec2T& v) const;        // Equality
+    constexpr bool operator!=(const Vec2T& v) const;        // Inequality
+
+    bool operator<(const Vec2T& v) const;           // Magnitude less than
+    bool operator>(const Vec2T& v) const;           // Magnitude greater than
+    bool operator<=(const Vec2T& v) const;          // Magnitude less than or equal to
+    bool operator>=(const Vec2T& v) const;          // Magnitude greater than or equal to
+
+
+    // Utilities
+    constexpr T DotProduct(const Vec2T& v) const;
+    T Distance(const Vec2T& v) const;
+    T Magnitude() const;
+    void Normalize();
+
+    // Squared versions, without a square root, for when only the order matters
+    constexpr T DistanceSquared(const Vec2T& v) const;
+    constexpr T MagnitudeSquared() const;
+
+    // Is v within, or at least, the given distance of this point, for a distance of any sign
+    constexpr bool WithinDistance(const Vec2T& v, T d) const;
+    constexpr bool BeyondDistance(const Vec2T& v, T d) const;
+
+
+    // Output to a stream
+    template <class U>
+    friend std::ostream& operator<<(std::ostream& os, const Vec2T<U>& v);
+
+protected:
+    // The internal representation
+    T _v[2];
+
+    // Indeces
+    enum { X = 0, Y = 1 };
+};
+
+
+typedef Vec2T<double> Vec2;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline constexpr Vec2T<T>::Vec2T() : _v{ T(0), T(0) } {
+}
+
+template <class T>
+inline constexpr Vec2T<T>::Vec2T(const T v[2]) : _v{ v[X], v[Y] } {
+}
+
+template <class T>
+inline constexpr Vec2T<T>::Vec2T(T x, T y) : _v{ x, y } {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline void Vec2T<T>::MakeIdentity() {
+    Set(T(0), T(0));
+}
+
+template <class T>
+inline void Vec2T<T>::Set(const T v[2]) {
+    Set(v[X], v[Y]);
+}
+
+template <class T>
+inline void Vec2T<T>::Set(T x, T y) {
+    _v[X] = x;
+    _v[Y] = y;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline T& Vec2T<T>::x() {
+    return _v[X];
+}
+
+template <class T>
+inline T& Vec2T<T>::y() {
+    return _v[Y];
+}
+
+
+template <class T>
+inline constexpr T Vec2T<T>::x() const {
+    return _v[X];
+}
+
+template <class T>
+inline constexpr T Vec2T<T>::y() const {
+    return _v[Y];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Operators
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline T& Vec2T<T>::operator[](int i) {
+    return _v[i];
+}
+
+template <class T>
+inline constexpr T Vec2T<T>::operator[](int i) const {
+    return _v[i];
+}
+
+template <class T>
+inline constexpr const Vec2T<T> Vec2T<T>::operator+(const Vec2T& v) const {
+    return Vec2T(_v[X] + v._v[X],
+                 _v[Y] + v._v[Y]);
+}
+
+template <class T>
+inline constexpr const Vec2T<T> Vec2T<T>::operator-(const Vec2T& v) const {
+    return Vec2T(_v[X] - v._v[X],
+                 _v[Y] - v._v[Y]);
+}
+
+
+template <class T>
+inline constexpr const Vec2T<T> Vec2T<T>::operator*(T scale) const {
+    return Vec2T(_v[X] * scale,
+                 _v[Y] * scale);
+}
+
+
+template <class T>
+inline Vec2T<T>& Vec2T<T>::operator+=(const Vec2T& v) {
+    return (*this = *this + v);
+}
+
+template <class T>
+inline Vec2T<T>& Vec2T<T>::operator-=(const Vec2T& v) {
+    return (*this = *this - v);
+}
+
+
+template <class T>
+inline Vec2T<T>& Vec2T<T>::operator*=(T scale) {
+    return (*this = *this * scale);
+}
+
+
+template <class T>
+inline constexpr const Vec2T<T> Vec2T<T>::operator!() const {
+    return Vec2T(-_v[X], -_v[Y]);
+}
+
+
+template <class T>
+inline constexpr bool Vec2T<T>::operator==(const Vec2T& v) const {
+    return (_v[X] == v._v[X] &&
+            _v[Y] == v._v[Y]);
+}
+
+template <class T>
+inline constexpr bool Vec2T<T>::operator!=(const Vec2T& v) const {
+    return !(*this == v);
+}
+
+
+template <class T>
+inline bool Vec2T<T>::operator<(const Vec2T& v) const {
+    return (Magnitude() < v.Magnitude());
+}
+
+template <class T>
+inline bool Vec2T<T>::operator>(const Vec2T& v) const {
+    return (Magnitude() > v.Magnitude());
+}
+
+template <class T>
+inline bool Vec2T<T>::operator<=(const Vec2T& v) const {
+    return (Magnitude() <= v.Magnitude());
+}
+
+template <class T>
+inline bool Vec2T<T>::operator>=(const Vec2T& v) const {
+    return (Magnitude() >= v.Magnitude());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline constexpr T Vec2T<T>::DotProduct(const Vec2T& v) const {
+    return (_v[X] * v._v[X] +
+            _v[Y] * v._v[Y]);
+}
+
+template <class T>
+inline T Vec2T<T>::Distance(const Vec2T& v) const {
+    Vec2T diff = *this - v;
+    return diff.Magnitude();
+}
+
+template <class T>
+inline T Vec2T<T>::Magnitude() const {
+    return sqrt(MagnitudeSquared());
+}
+
+template <class T>
+inline void Vec2T<T>::Normalize() {
+    T magnitude = Magnitude();
+
+    if (magnitude <= T(0)) {
+        return;
+    }
+
+    T scale = T(1) / magnitude;
+
+    _v[X] *= scale;
+    _v[Y] *= scale;
+}
+
+
+template <class T>
+inline constexpr T Vec2T<T>::DistanceSquared(const Vec2T& v) const {
+    return (*this - v).MagnitudeSquared();
+}
+
+template <class T>
+inline constexpr T Vec2T<T>::MagnitudeSquared() const {
+    return (_v[X] * _v[X] +
+            _v[Y] * _v[Y]);
+}
+
+template <class T>
+inline constexpr bool Vec2T<T>::WithinDistance(const Vec2T& v, T d) const {
+    return d >= T(0) && DistanceSquared(v) <= d * d;
+}
+
+template <class T>
+inline constexpr bool Vec2T<T>::BeyondDistance(const Vec2T& v, T d) const {
+    return d <= T(0) || DistanceSquared(v) >= d * d;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Output to a stream
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline std::ostream& operator<<(std::ostream& os, const Vec2T<T>& v) {
+    return (os << "("
+               << v._v[Vec2T<T>::X] << ", "
+               << v._v[Vec2T<T>::Y]
+               << ")");
+}
+
+
+#endif
\ No newline at end of file
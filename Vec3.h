@@ -4,24 +4,32 @@
 //
 // Author:      David Borland
 //
-// Description: 3D vector class.  
+// Description: 3D vector class.  Templated on the scalar type and defined entirely in the
+//              header, so it can be inlined.  Vec3 is the double version.
 //
-/////////////////////////////////////////////////////////////////////////////////////////////// 
+///////////////////////////////////////////////////////////////////////////////////////////////
 
 
 #ifndef VEC3_H
 #define VEC3_H
 
 
+#include <math.h>
+
 #include <iostream>
 
 
-class Vec3 {
+template <class T>
+class Vec3T {
 public:
+    // Number of components
+    static const int Dimension = 3;
+
+
     // Constructors
-    Vec3();                                         // Set to (0, 0, 0)
-    Vec3(double v[3]);                              // Set from array
-    Vec3(double x, double y, double z);             // Set components
+    constexpr Vec3T();                              // Set to (0, 0, 0)
+    constexpr Vec3T(const T v[3]);                  // Set from array
+    constexpr Vec3T(T x, T y, T z);                 // Set components
 
 
     // Use default copy constructor
@@ -31,65 +39,333 @@ public:
 
     // Set values
     void MakeIdentity();                            // Set to (0, 0, 0)
-    void Set(double v[3]);                          // Set from array
-    void Set(double x, double y, double z);         // Set components
+    void Set(const T v[3]);                         // Set from array
+    void Set(T x, T y, T z);                        // Set components
+
 
-        
     // Element access
-    double& x();                                    // Read/write access
-    double& y();                                    // Read/write access
-    double& z();                                    // Read/write access
+    T& x();                                         // Read/write access
+    T& y();                                         // Read/write access
+    T& z();                                         // Read/write access
 
-    double x() const;                               // Just read access
-    double y() const;                               // Just read access
-    double z() const;                               // Just read access
+    constexpr T x() const;                          // Just read access
+    constexpr T y() const;                          // Just read access
+    constexpr T z() const;                          // Just read access
 
 
     // Operators
-    double operator[](int i) const;                 // Index
+    T& operator[](int i);                           // Index, read/write access
+    constexpr T operator[](int i) const;            // Index
 
-    const Vec3 operator+(const Vec3& v) const;      // Vector addition
-    const Vec3 operator-(const Vec3& v) const;      // Vector subtraction
+    constexpr const Vec3T operator+(const Vec3T& v) const;  // Vector addition
+    constexpr const Vec3T operator-(const Vec3T& v) const;  // Vector subtraction
 
-    const Vec3 operator*(const Vec3& v) const;      // Cross product
-    const Vec3 operator*(double scale) const;       // Scale
+    constexpr const Vec3T operator*(const Vec3T& v) const;  // Cross product
+    constexpr const Vec3T operator*(T scale) const;         // Scale
 
-    Vec3& operator+=(const Vec3& v);                // Vector addition
-    Vec3& operator-=(const Vec3& v);                // Vector subtraction
+    Vec3T& operator+=(const Vec3T& v);              // Vector addition
+    Vec3T& operator-=(const Vec3T& v);              // Vector subtraction
 
-    Vec3& operator*=(const Vec3& v);                // Cross product
-    Vec3& operator*=(double scale);                 // Scale
+    Vec3T& operator*=(const Vec3T& v);              // Cross product
+    Vec3T& operator*=(T scale);                     // Scale
 
-    const Vec3 operator!() const;                   // Invert
+    constexpr const Vec3T operator!() const;        // Invert
 
-    bool operator==(const Vec3& v) const;           // Equality
-    bool operator!=(const Vec3& v) const;           // Inequality
+    constexpr bool operator==(const Vec3T& v) const;        // Equality
+    constexpr bool operator!=(const Vec3T& v) const;        // Inequality
 
-    bool operator<(const Vec3& v) const;            // Magnitude less than
-    bool operator>(const Vec3& v) const;            // Magnitude greater than
-    bool operator<=(const Vec3& v) const;           // Magnitude less than or equal to
-    bool operator>=(const Vec3& v) const;           // Magnitude greater than or equal to
+    bool operator<(const Vec3T& v) const;           // Magnitude less than
+    bool operator>(const Vec3T& v) const;           // Magnitude greater than
+    bool operator<=(const Vec3T& v) const;          // Magnitude less than or equal to
+    bool operator>=(const Vec3T& v) const;          // Magnitude greater than or equal to
 
 
     // Utilities
-    double DotProduct(const Vec3& v) const;
-    double Distance(const Vec3& v) const;
-    double Magnitude() const;
+    constexpr T DotProduct(const Vec3T& v) const;
+    T Distance(const Vec3T& v) const;
+    T Magnitude() const;
     void Normalize();
 
+    // Squared versions, without a square root, for when only the order matters
+    constexpr T DistanceSquared(const Vec3T& v) const;
+    constexpr T MagnitudeSquared() const;
+
+    // Is v within, or at least, the given distance of this point, for a distance of any sign
+    constexpr bool WithinDistance(const Vec3T& v, T d) const;
+    constexpr bool BeyondDistance(const Vec3T& v, T d) const;
+
 
     // Output to a stream
-    friend std::ostream& operator<<(std::ostream& os, const Vec3& v);
+    template <class U>
+    friend std::ostream& operator<<(std::ostream& os, const Vec3T<U>& v);
 
 protected:
     // The internal representation
-    double _v[3];                    
+    T _v[3];
 
     // Indeces
-    const static int X;
-    const static int Y;
-    const static int Z;
+    enum { X = 0, Y = 1, Z = 2 };
 };
 
 
+typedef Vec3T<double> Vec3;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Constructors
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline constexpr Vec3T<T>::Vec3T() : _v{ T(0), T(0), T(0) } {
+}
+
+template <class T>
+inline constexpr Vec3T<T>::Vec3T(const T v[3]) : _v{ v[X], v[Y], v[Z] } {
+}
+
+template <class T>
+inline constexpr Vec3T<T>::Vec3T(T x, T y, T z) : _v{ x, y, z } {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Set values
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline void Vec3T<T>::MakeIdentity() {
+    Set(T(0), T(0), T(0));
+}
+
+template <class T>
+inline void Vec3T<T>::Set(const T v[3]) {
+    Set(v[X], v[Y], v[Z]);
+}
+
+template <class T>
+inline void Vec3T<T>::Set(T x, T y, T z) {
+    _v[X] = x;
+    _v[Y] = y;
+    _v[Z] = z;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Element access
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline T& Vec3T<T>::x() {
+    return _v[X];
+}
+
+template <class T>
+inline T& Vec3T<T>::y() {
+    return _v[Y];
+}
+
+template <class T>
+inline T& Vec3T<T>::z() {
+    return _v[Z];
+}
+
+
+template <class T>
+inline constexpr T Vec3T<T>::x() const {
+    return _v[X];
+}
+
+template <class T>
+inline constexpr T Vec3T<T>::y() const {
+    return _v[Y];
+}
+
+template <class T>
+inline constexpr T Vec3T<T>::z() const {
+    return _v[Z];
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Operators
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline T& Vec3T<T>::operator[](int i) {
+    return _v[i];
+}
+
+template <class T>
+inline constexpr T Vec3T<T>::operator[](int i) const {
+    return _v[i];
+}
+
+template <class T>
+inline constexpr const Vec3T<T> Vec3T<T>::operator+(const Vec3T& v) const {
+    return Vec3T(_v[X] + v._v[X],
+                 _v[Y] + v._v[Y],
+                 _v[Z] + v._v[Z]);
+}
+
+template <class T>
+inline constexpr const Vec3T<T> Vec3T<T>::operator-(const Vec3T& v) const {
+    return Vec3T(_v[X] - v._v[X],
+                 _v[Y] - v._v[Y],
+                 _v[Z] - v._v[Z]);
+}
+
+
+template <class T>
+inline constexpr const Vec3T<T> Vec3T<T>::operator*(const Vec3T& v) const {
+    return Vec3T(_v[Y] * v._v[Z] - _v[Z] * v._v[Y],
+                 _v[Z] * v._v[X] - _v[X] * v._v[Z],
+                 _v[X] * v._v[Y] - _v[Y] * v._v[X]);
+}
+
+template <class T>
+inline constexpr const Vec3T<T> Vec3T<T>::operator*(T scale) const {
+    return Vec3T(_v[X] * scale,
+                 _v[Y] * scale,
+                 _v[Z] * scale);
+}
+
+
+template <class T>
+inline Vec3T<T>& Vec3T<T>::operator+=(const Vec3T& v) {
+    return (*this = *this + v);
+}
+
+template <class T>
+inline Vec3T<T>& Vec3T<T>::operator-=(const Vec3T& v) {
+    return (*this = *this - v);
+}
+
+
+template <class T>
+inline Vec3T<T>& Vec3T<T>::operator*=(const Vec3T& v) {
+    return (*this = *this * v);
+}
+
+template <class T>
+inline Vec3T<T>& Vec3T<T>::operator*=(T scale) {
+    return (*this = *this * scale);
+}
+
+
+template <class T>
+inline constexpr const Vec3T<T> Vec3T<T>::operator!() const {
+    return Vec3T(-_v[X], -_v[Y], -_v[Z]);
+}
+
+
+template <class T>
+inline constexpr bool Vec3T<T>::operator==(const Vec3T& v) const {
+    return (_v[X] == v._v[X] &&
+            _v[Y] == v._v[Y] &&
+            _v[Z] == v._v[Z]);
+}
+
+template <class T>
+inline constexpr bool Vec3T<T>::operator!=(const Vec3T& v) const {
+    return !(*this == v);
+}
+
+
+template <class T>
+inline bool Vec3T<T>::operator<(const Vec3T& v) const {
+    return (Magnitude() < v.Magnitude());
+}
+
+template <class T>
+inline bool Vec3T<T>::operator>(const Vec3T& v) const {
+    return (Magnitude() > v.Magnitude());
+}
+
+template <class T>
+inline bool Vec3T<T>::operator<=(const Vec3T& v) const {
+    return (Magnitude() <= v.Magnitude());
+}
+
+template <class T>
+inline bool Vec3T<T>::operator>=(const Vec3T& v) const {
+    return (Magnitude() >= v.Magnitude());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Utilities
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline constexpr T Vec3T<T>::DotProduct(const Vec3T& v) const {
+    return (_v[X] * v._v[X] +
+            _v[Y] * v._v[Y] +
+            _v[Z] * v._v[Z]);
+}
+
+template <class T>
+inline T Vec3T<T>::Distance(const Vec3T& v) const {
+    Vec3T diff = *this - v;
+    return diff.Magnitude();
+}
+
+template <class T>
+inline T Vec3T<T>::Magnitude() const {
+    return sqrt(MagnitudeSquared());
+}
+
+template <class T>
+inline void Vec3T<T>::Normalize() {
+    T magnitude = Magnitude();
+
+    if (magnitude <= T(0)) {
+//        std::cout << "Vec3::Normalize() : Vector has 0 magnitude." << std::endl;
+        return;
+    }
+
+    T scale = T(1) / magnitude;
+
+    _v[X] *= scale;
+    _v[Y] *= scale;
+    _v[Z] *= scale;
+}
+
+
+template <class T>
+inline constexpr T Vec3T<T>::DistanceSquared(const Vec3T& v) const {
+    return (*this - v).MagnitudeSquared();
+}
+
+template <class T>
+inline constexpr T Vec3T<T>::MagnitudeSquared() const {
+    return (_v[X] * _v[X] +
+            _v[Y] * _v[Y] +
+            _v[Z] * _v[Z]);
+}
+
+template <class T>
+inline constexpr bool Vec3T<T>::WithinDistance(const Vec3T& v, T d) const {
+    return d >= T(0) && DistanceSquared(v) <= d * d;
+}
+
+template <class T>
+inline constexpr bool Vec3T<T>::BeyondDistance(const Vec3T& v, T d) const {
+    return d <= T(0) || DistanceSquared(v) >= d * d;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Output to a stream
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+template <class T>
+inline std::ostream& operator<<(std::ostream& os, const Vec3T<T>& v) {
+    return (os << "("
+               << v._v[Vec3T<T>::X] << ", "
+               << v._v[Vec3T<T>::Y] << ", "
+               << v._v[Vec3T<T>::Z]
+               << ")");
+}
+
+
 #endif
\ No newline at end of file
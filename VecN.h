@@ -0,0 +1,40 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        VecN.h
+//
+// Author:      David Borland
+//
+// Description: Chooses the vector class for a dimension, so the geometry and solver can be
+//              templated on the dimension as well as the scalar type.  VecT<T, 2> is Vec2T<T>
+//              and VecT<T, 3> is Vec3T<T>.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef VECN_H
+#define VECN_H
+
+
+#include "Vec2.h"
+#include "Vec3.h"
+
+
+template <class T, int D>
+struct VecType;
+
+template <class T>
+struct VecType<T, 2> {
+    typedef Vec2T<T> Type;
+};
+
+template <class T>
+struct VecType<T, 3> {
+    typedef Vec3T<T> Type;
+};
+
+
+template <class T, int D>
+using VecT = typename VecType<T, D>::Type;
+
+
+#endif
\ No newline at end of file